@@ -25,170 +25,709 @@
 #include "argengine.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdlib>
+#include <deque>
+#include <fstream>
 #include <iostream>
-#include <map>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ARGENGINE_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#define environ _environ
+#else
+extern char ** environ;
+#endif
 
 namespace juzzlin {
 
 const auto SHOW_THIS_HELP_TEXT = "Show this help.";
 
-class Argengine::Impl
+using ArgumentViewVector = std::pmr::vector<std::string_view>;
+
+//! Marks the end of the options. The arguments after it are positional arguments.
+constexpr std::string_view EndOfOptions = "--";
+
+namespace {
+
+//! Memory resource that counts the allocations passed to the upstream resource.
+class CountingResource : public std::pmr::memory_resource
 {
 public:
-    Impl(const ArgumentVector & args, bool addDefaultHelp)
-      : m_args(args)
+    explicit CountingResource(std::pmr::memory_resource * upstream = std::pmr::new_delete_resource())
+      : m_upstream(upstream)
     {
-        if (m_args.empty()) {
-            throw std::runtime_error(name() + ": Argument vector is empty!");
-        }
+    }
 
-        if (addDefaultHelp) {
-            addHelp();
-        }
+    void resetCounters()
+    {
+        m_allocations = 0;
+        m_allocatedBytes = 0;
+    }
+
+    size_t allocations() const
+    {
+        return m_allocations;
+    }
+
+    size_t allocatedBytes() const
+    {
+        return m_allocatedBytes;
+    }
+
+    //! Counts an allocation made directly from the upstream resource, e.g. of an object that may outlive this resource.
+    void count(size_t bytes)
+    {
+        m_allocations++;
+        m_allocatedBytes += bytes;
+    }
+
+    //! Adds the counters of another resource.
+    void count(const CountingResource & other)
+    {
+        m_allocations += other.m_allocations;
+        m_allocatedBytes += other.m_allocatedBytes;
     }
 
 private:
-    struct OptionDefinition;
+    void * do_allocate(size_t bytes, size_t alignment) override
+    {
+        m_allocations++;
+        m_allocatedBytes += bytes;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void * ptr, size_t bytes, size_t alignment) override
+    {
+        m_upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource * m_upstream;
+
+    size_t m_allocations = 0;
+
+    size_t m_allocatedBytes = 0;
+};
 
+//! \return The given resource or the default resource if nullptr.
+std::pmr::memory_resource * resourceOrDefault(std::pmr::memory_resource * resource)
+{
+    return resource ? resource : std::pmr::get_default_resource();
+}
+
+//! Base of the classes allocated from a memory resource with `new (resource) T(...)`. The resource and the size are
+//! stored before the object, so that a plain delete, e.g. by std::unique_ptr, returns the memory to the resource.
+class ResourceAllocated
+{
 public:
-    std::shared_ptr<OptionDefinition> addOption(const OptionSet & optionVariants, ValuelessCallback callback, bool required, const std::string & infoText)
+    static void * operator new(size_t size, std::pmr::memory_resource * resource)
     {
-        return addOptionCommon(optionVariants, callback, required, infoText);
+        const auto memory = static_cast<std::byte *>(resource->allocate(HeaderSize + size, alignof(std::max_align_t)));
+        new (memory) Header { resource, size };
+        return memory + HeaderSize;
     }
 
-    std::shared_ptr<OptionDefinition> addOption(const OptionSet & optionVariants, SingleStringCallback callback, bool required, const std::string & infoText, const std::string & valueName)
+    //! Counts the allocation, but the memory is returned directly to the resource, so the object may outlive the counter.
+    static void * operator new(size_t size, std::pmr::memory_resource * resource, CountingResource & counter)
     {
-        const auto od = addOptionCommon(optionVariants, callback, required, infoText);
-        od->valueName = valueName;
-        return od;
+        counter.count(HeaderSize + size);
+        return operator new(size, resource);
     }
 
-    void addConflictingOptions(const OptionSet & conflictingOptionSet)
+    static void operator delete(void * object)
     {
-        m_conflictingOptionSets.push_back(conflictingOptionSet);
+        const auto memory = static_cast<std::byte *>(object) - HeaderSize;
+        const auto header = *std::launder(reinterpret_cast<Header *>(memory));
+        header.resource->deallocate(memory, HeaderSize + header.size, alignof(std::max_align_t));
     }
 
-    void addOptionGroup(const OptionSet & optionGroup)
+    //! Called if the constructor throws.
+    static void operator delete(void * object, std::pmr::memory_resource *)
     {
-        m_optionGroupSets.push_back(optionGroup);
+        operator delete(object);
     }
 
-    ArgumentVector arguments() const
+    //! Called if the constructor throws.
+    static void operator delete(void * object, std::pmr::memory_resource *, CountingResource &)
     {
-        return m_args;
+        operator delete(object);
     }
 
-    void setOutputStream(std::ostream & out)
+private:
+    struct Header
+    {
+        std::pmr::memory_resource * resource;
+
+        size_t size;
+    };
+
+    //! Keeps the object aligned as if it was allocated by the global new.
+    static constexpr size_t HeaderSize = (sizeof(Header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+};
+
+//! Allocator for std::allocate_shared() that counts the allocations, but returns the memory directly to the resource,
+//! so that the object may outlive the counter.
+template<typename T>
+class CountedAllocator
+{
+public:
+    using value_type = T;
+
+    CountedAllocator(std::pmr::memory_resource * resource, CountingResource & counter)
+      : m_resource(resource)
+      , m_counter(&counter)
     {
-        m_out = &out;
     }
 
-    void setHelpText(const std::string & helpText)
+    template<typename U>
+    CountedAllocator(const CountedAllocator<U> & other)
+      : m_resource(other.m_resource)
+      , m_counter(other.m_counter)
     {
-        m_helpText = helpText;
     }
 
-    std::string helpText() const
+    T * allocate(size_t count)
     {
-        return m_helpText;
+        m_counter->count(count * sizeof(T));
+        return static_cast<T *>(m_resource->allocate(count * sizeof(T), alignof(T)));
     }
 
-    void setHelpSorting(HelpSorting helpSorting)
+    void deallocate(T * object, size_t count)
     {
-        m_helpSorting = helpSorting;
+        m_resource->deallocate(object, count * sizeof(T), alignof(T));
     }
 
-    void setPositionalArgumentCallback(MultiStringCallback callback)
+    template<typename U>
+    bool operator==(const CountedAllocator<U> & other) const
     {
-        m_positionalArgumentCallback = callback;
+        return m_resource == other.m_resource;
     }
 
-    void printHelp() const
+    template<typename U>
+    bool operator!=(const CountedAllocator<U> & other) const
     {
-        if (!m_helpText.empty()) {
-            *m_out << m_helpText << std::endl
-                   << std::endl;
+        return !(*this == other);
+    }
+
+private:
+    template<typename U>
+    friend class CountedAllocator;
+
+    std::pmr::memory_resource * m_resource;
+
+    CountingResource * m_counter;
+};
+
+//! Destroys an object allocated from a monotonic arena. The memory is freed with the arena.
+struct ArenaDelete
+{
+    template<typename T>
+    void operator()(T * object) const
+    {
+        object->~T();
+    }
+};
+
+//! Throws std::runtime_error with the message. Without exceptions the message is printed and the program aborted.
+[[noreturn]] void throwError(const std::string & message)
+{
+#ifdef ARGENGINE_EXCEPTIONS
+    throw std::runtime_error(message);
+#else
+    std::cerr << message << std::endl;
+    std::abort();
+#endif
+}
+
+//! Adds the time elapsed during its lifetime to the given duration.
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(std::chrono::nanoseconds & time)
+      : m_time(time)
+      , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~PhaseTimer()
+    {
+        m_time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+    }
+
+private:
+    std::chrono::nanoseconds & m_time;
+
+    std::chrono::steady_clock::time_point m_start;
+};
+
+template<typename Function>
+auto measure(std::chrono::nanoseconds & time, Function && function) -> decltype(function())
+{
+    const PhaseTimer timer { time };
+    return function();
+}
+
+//! \return True if text matches the pattern with wildcards '*' (any sequence) and '?' (any character).
+bool globMatch(std::string_view pattern, std::string_view text)
+{
+    size_t p = 0;
+    size_t t = 0;
+    size_t starPattern = std::string_view::npos;
+    size_t starText = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            p++;
+            t++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starPattern = p++;
+            starText = t;
+        } else if (starPattern != std::string_view::npos) {
+            p = starPattern + 1;
+            t = ++starText;
+        } else {
+            return false;
         }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
 
-        *m_out << "Options:" << std::endl
-               << std::endl;
+std::string_view trim(std::string_view text)
+{
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == text.npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
 
-        auto sortedOptionDefinitions = m_optionDefinitions;
-        if (m_helpSorting == HelpSorting::Ascending) {
-            std::sort(sortedOptionDefinitions.begin(), sortedOptionDefinitions.end(), [](const OptionDefinitionSP & l, const OptionDefinitionSP & r) {
-                return l->getVariantsString() < r->getVariantsString();
-            });
+//! \return The option name without the leading dashes, e.g. "output" for "--output".
+std::string_view stripDashes(std::string_view option)
+{
+    const auto first = option.find_first_not_of('-');
+    return first == option.npos ? std::string_view {} : option.substr(first);
+}
+
+//! Calls function(key, value, line) for each "key = value" line of an INI-style config. Empty lines, comments
+//! starting with '#' or ';' and [section] headers are skipped. Whitespace around keys and values and double quotes
+//! around values are removed. The function returns false to stop.
+//! \return 0 on success or if stopped, otherwise the number of the first line that is not of the form "key = value".
+template<typename Function>
+size_t forEachConfigEntry(std::string_view config, Function && function)
+{
+    size_t lineNumber = 0;
+    while (!config.empty()) {
+        lineNumber++;
+        const auto lineEnd = config.find('\n');
+        const auto line = trim(config.substr(0, lineEnd));
+        config = lineEnd == config.npos ? std::string_view {} : config.substr(lineEnd + 1);
+        if (line.empty() || line.front() == '#' || line.front() == ';' || (line.front() == '[' && line.back() == ']')) {
+            continue;
+        }
+        const auto pos = line.find('=');
+        if (pos == line.npos) {
+            return lineNumber;
+        }
+        const auto key = trim(line.substr(0, pos));
+        auto value = trim(line.substr(pos + 1));
+        if (key.empty()) {
+            return lineNumber;
         }
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        if (!function(key, value, lineNumber)) {
+            return 0;
+        }
+    }
+    return 0;
+}
 
-        using ArgumentAndHelpText = std::pair<std::string, std::string>;
-        std::vector<ArgumentAndHelpText> helpTexts;
-        size_t maxLength = 0;
-        for (auto && option : sortedOptionDefinitions) {
-            const auto variantsString = option->getVariantsString() + (option->singleStringCallback ? " [" + option->valueName + "]" : "");
-            maxLength = std::max(variantsString.size(), maxLength);
-            helpTexts.push_back({ variantsString, option->infoText });
+//! Bit set stored as 64-bit words.
+using Bitmask = std::pmr::vector<uint64_t>;
+
+constexpr size_t BitsPerWord = 64;
+
+size_t bitmaskWordCount(size_t bits)
+{
+    return (bits + BitsPerWord - 1) / BitsPerWord;
+}
+
+void setBit(uint64_t * words, size_t bit)
+{
+    words[bit / BitsPerWord] |= uint64_t { 1 } << (bit % BitsPerWord);
+}
+
+bool testBit(const uint64_t * words, size_t bit)
+{
+    return words[bit / BitsPerWord] & (uint64_t { 1 } << (bit % BitsPerWord));
+}
+
+size_t countBits(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    size_t count = 0;
+    for (; word; word &= word - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+size_t countTrailingZeros(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    size_t count = 0;
+    for (; !(word & 1); word >>= 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+//! Calls function(bit) for each set bit in ascending order.
+template<typename Function>
+void forEachSetBit(const uint64_t * words, size_t wordCount, Function && function)
+{
+    for (size_t i = 0; i < wordCount; i++) {
+        for (auto word = words[i]; word; word &= word - 1) {
+            function(i * BitsPerWord + countTrailingZeros(word));
         }
-        const size_t margin = 2;
-        for (auto && optionText : helpTexts) {
-            *m_out << optionText.first;
-            for (size_t i = 0; i < maxLength + margin - optionText.first.size(); i++) {
-                *m_out << " ";
+    }
+}
+
+//! A file mapped privately to memory. The contents can be modified in place without modifying the file.
+//! Falls back to reading the file into a buffer if mmap is not available.
+class MappedFile
+{
+public:
+    //! \param resource Resource for the buffer if the file can't be mapped.
+    MappedFile(const char * path, [[maybe_unused]] std::pmr::memory_resource * resource)
+#ifndef ARGENGINE_USE_MMAP
+      : m_buffer(resource)
+#endif
+    {
+#ifdef ARGENGINE_USE_MMAP
+        if (const int fd = ::open(path, O_RDONLY); fd >= 0) {
+            struct stat fileStat;
+            if (::fstat(fd, &fileStat) == 0) {
+                m_size = static_cast<size_t>(fileStat.st_size);
+                if (!m_size) {
+                    m_valid = true;
+                } else if (void * data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0); data != MAP_FAILED) {
+                    m_data = static_cast<char *>(data);
+                    m_valid = true;
+                }
             }
-            *m_out << optionText.second;
-            *m_out << std::endl;
+            ::close(fd);
         }
-        *m_out << std::endl;
+#else
+        if (std::ifstream in { path, std::ios::binary }; in) {
+            m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+            m_valid = true;
+        }
+#endif
     }
 
-    void parse()
+    ~MappedFile()
     {
-        processArgs(true);
+#ifdef ARGENGINE_USE_MMAP
+        if (m_data) {
+            ::munmap(m_data, m_size);
+        }
+#endif
+    }
 
-        checkRequired();
+    MappedFile(const MappedFile & other) = delete;
+    MappedFile & operator=(const MappedFile & other) = delete;
 
-        processArgs(false);
+    bool isValid() const
+    {
+        return m_valid;
     }
 
-    void setAutoDash(bool autoDash)
+    char * begin()
     {
-        m_autoDash = autoDash;
+        return m_data;
     }
 
-    ~Impl() = default;
+    char * end()
+    {
+        return m_data + m_size;
+    }
 
 private:
+    char * m_data = nullptr;
+
+    size_t m_size = 0;
+
+    bool m_valid = false;
+
+#ifndef ARGENGINE_USE_MMAP
+    std::pmr::string m_buffer;
+#endif
+};
+
+using MappedFileSP = std::shared_ptr<MappedFile>;
+
+//! Splits text into arguments the way a POSIX shell does: on whitespace (and NUL), honoring single quotes,
+//! double quotes and backslash escapes. Quotes and escapes are removed by compacting the text in place, so the
+//! added tokens are views to the text itself. Text without quotes or escapes is never written to.
+//! \return False if a quote is not terminated.
+bool splitInPlace(char * begin, char * end, ArgumentViewVector & tokens)
+{
+    const auto isSeparator = [](char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v' || c == '\0';
+    };
+
+    char * in = begin;
+    while (in != end) {
+        while (in != end && isSeparator(*in)) {
+            in++;
+        }
+        if (in == end) {
+            break;
+        }
+        char * const tokenBegin = in;
+        char * out = in;
+        const auto put = [&out](const char * c) {
+            if (out != c) {
+                *out = *c;
+            }
+            out++;
+        };
+        char quote = 0;
+        while (in != end && (quote || !isSeparator(*in))) {
+            if (quote == '\'') {
+                if (*in == '\'') {
+                    quote = 0;
+                } else {
+                    put(in);
+                }
+            } else if (quote == '"') {
+                if (*in == '"') {
+                    quote = 0;
+                } else if (*in == '\\' && in + 1 != end && (in[1] == '"' || in[1] == '\\' || in[1] == '$' || in[1] == '`')) {
+                    put(++in);
+                } else if (*in == '\\' && in + 1 != end && in[1] == '\n') {
+                    in++;
+                } else {
+                    put(in);
+                }
+            } else if (*in == '\'' || *in == '"') {
+                quote = *in;
+            } else if (*in == '\\' && in + 1 != end) {
+                if (*++in != '\n') {
+                    put(in);
+                }
+            } else {
+                put(in);
+            }
+            in++;
+        }
+        if (quote) {
+            return false;
+        }
+        tokens.emplace_back(tokenBegin, static_cast<size_t>(out - tokenBegin));
+    }
+    return true;
+}
+
+} // namespace
+
+//! The option configuration. It's shared by all parses made with it and it must not be modified once compiled.
+class Argengine::Schema
+{
+public:
+    using Int64Callback = std::function<void(int64_t)>;
+
+    using DoubleCallback = std::function<void(double)>;
+
+    using BoolCallback = std::function<void(bool)>;
+
+    //! Value of a typed option converted during resolution.
+    using TypedValue = std::variant<std::monostate, int64_t, double, bool>;
+
+    explicit Schema(std::pmr::memory_resource * resource)
+      : m_resource(resource)
+      , m_helpText(resource)
+      , m_optionDefinitions(resource)
+      , m_optionIndex(resource)
+      , m_variantTrie(resource)
+      , m_conflictingOptionSets(resource)
+      , m_optionGroupSets(resource)
+      , m_requiredMask(resource)
+      , m_environmentVariables(resource)
+      , m_environmentVariableIndex(resource)
+      , m_configKeyIndex(resource)
+      , m_subcommands(resource)
+      , m_subcommandIndex(resource)
+      , m_helpSection(resource)
+      , m_renderedHelp(resource)
+      , m_helpLines(resource)
+    {
+    }
+
+    //! Copies the schema into the given resource. The option definitions are shared.
+    Schema(const Schema & other, std::pmr::memory_resource * resource)
+      : m_resource(resource)
+      , m_helpText(other.m_helpText, resource)
+      , m_helpSorting(other.m_helpSorting)
+      , m_optionDefinitions(other.m_optionDefinitions, resource)
+      , m_optionIndex(other.m_optionIndex, resource)
+      , m_variantTrie(other.m_variantTrie, resource)
+      , m_conflictingOptionSets(other.m_conflictingOptionSets, resource)
+      , m_optionGroupSets(other.m_optionGroupSets, resource)
+      , m_requiredMask(other.m_requiredMask, resource)
+      , m_environmentVariables(other.m_environmentVariables, resource)
+      , m_environmentVariableIndex(resource)
+      , m_configKeyIndex(other.m_configKeyIndex, resource)
+      , m_subcommands(other.m_subcommands, resource)
+      , m_subcommandIndex(resource)
+      , m_positionalArgumentCallback(other.m_positionalArgumentCallback)
+      , m_positionalArgumentViewCallback(other.m_positionalArgumentViewCallback)
+      , m_positionalArgumentBatchSize(other.m_positionalArgumentBatchSize)
+      , m_responseFileExpansion(other.m_responseFileExpansion)
+      , m_multiValueOptionCount(other.m_multiValueOptionCount)
+      , m_finalized(other.m_finalized)
+      , m_helpSection(other.m_helpSection, resource)
+      , m_renderedHelp(other.m_renderedHelp, resource)
+      , m_helpLines(other.m_helpLines, resource)
+      , m_helpColumn(other.m_helpColumn)
+      , m_helpHeaderLength(other.m_helpHeaderLength)
+      , m_helpOptionsEnd(other.m_helpOptionsEnd)
+      , m_helpRendered(other.m_helpRendered)
+    {
+        // The keys of the index are views to the names owned by this schema
+        for (auto && variable : m_environmentVariables) {
+            m_environmentVariableIndex[variable.first] = variable.second;
+        }
+        for (auto && subcommand : m_subcommands) {
+            m_subcommandIndex[subcommand.name] = &subcommand;
+        }
+    }
+
+    //! \return A new schema allocated, including its control block, from the given resource.
+    template<typename... Args>
+    static std::shared_ptr<Schema> create(std::pmr::memory_resource * resource, Args &&... args)
+    {
+        return std::allocate_shared<Schema>(std::pmr::polymorphic_allocator<Schema> { resource }, std::forward<Args>(args)..., resource);
+    }
+
+    //! Variants of an option. Compares with views, so that the variants can be looked up without copying them.
+    using VariantSet = std::pmr::set<std::pmr::string, std::less<>>;
+
+    //! The strings are allocated from the resource of the schema that created the definition.
     struct OptionDefinition
     {
-        OptionDefinition(const OptionSet & variants, ValuelessCallback callback, bool required, std::string infoText)
-          : variants(variants)
-          , valuelessCallback(callback)
-          , singleStringCallback(nullptr)
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : variants(variants.begin(), variants.end(), resource)
           , required(required)
-          , infoText(infoText)
+          , section(resource)
+          , variantsString(resource)
+          , infoText(infoText, resource)
+          , valueName(resource)
         {
         }
 
-        OptionDefinition(const OptionSet & variants, SingleStringCallback callback, bool required, std::string infoText)
-          : variants(variants)
-          , valuelessCallback(nullptr)
-          , singleStringCallback(callback)
-          , required(required)
-          , infoText(infoText)
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, ValuelessCallback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
+        {
+            valuelessCallback = callback;
+        }
+
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, SingleStringCallback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
         {
+            singleStringCallback = callback;
         }
 
-        bool matches(const OptionSet & variants) const
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, SingleStringViewCallback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
         {
-            return std::find_if(variants.begin(), variants.end(), [this](const auto & variant) {
-                       return this->variants.count(variant);
-                   })
-              != variants.end();
+            singleStringViewCallback = callback;
         }
 
-        std::string getVariantsString() const
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, Int64Callback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
         {
-            std::string str;
+            int64Callback = callback;
+        }
+
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, DoubleCallback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
+        {
+            doubleCallback = callback;
+        }
+
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, BoolCallback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
+        {
+            boolCallback = callback;
+        }
+
+        template<typename Variants>
+        OptionDefinition(const Variants & variants, MultiStringViewCallback callback, bool required, std::string_view infoText, std::pmr::memory_resource * resource)
+          : OptionDefinition(variants, required, infoText, resource)
+        {
+            multiValueCallback = callback;
+        }
+
+        bool hasValue() const
+        {
+            return singleStringCallback || singleStringViewCallback || int64Callback || doubleCallback || boolCallback || multiValueCallback;
+        }
+
+        bool isMultiValue() const
+        {
+            return multiValueCallback != nullptr;
+        }
+
+        //! \return The variants as shown in the help and in errors, e.g. "-f, --foo".
+        std::pmr::string buildVariantsString() const
+        {
+            std::pmr::string str { variants.get_allocator().resource() };
             size_t count = 0;
             for (auto rit = variants.rbegin(); rit != variants.rend(); rit++) {
                 str += *rit;
@@ -199,363 +738,2381 @@ private:
             return str;
         }
 
-        OptionSet variants;
+        VariantSet variants;
 
         ValuelessCallback valuelessCallback = nullptr;
 
         SingleStringCallback singleStringCallback = nullptr;
 
-        bool required = false;
+        SingleStringViewCallback singleStringViewCallback = nullptr;
+
+        Int64Callback int64Callback = nullptr;
+
+        DoubleCallback doubleCallback = nullptr;
+
+        BoolCallback boolCallback = nullptr;
+
+        ValueRange<int64_t> int64Range;
+
+        ValueRange<double> doubleRange;
 
-        bool applied = false;
+        MultiStringViewCallback multiValueCallback = nullptr;
+
+        Arity arity;
+
+        //! Index of the definition in the schema.
+        size_t id = 0;
+
+        //! Index of a multi-value definition among the multi-value definitions of the schema.
+        size_t multiValueId = 0;
+
+        bool required = false;
 
         bool isHelp = false;
 
-        std::string infoText;
+        //! Help section, empty if none.
+        std::pmr::string section;
+
+        //! Set by buildVariantsString() when the option is added.
+        std::pmr::string variantsString;
 
-        std::string valueName = "VALUE";
+        std::pmr::string infoText;
+
+        std::pmr::string valueName;
     };
 
     using OptionDefinitionSP = std::shared_ptr<OptionDefinition>;
 
-    using OptionDefinitionVector = std::vector<OptionDefinitionSP>;
+    using OptionDefinitionVector = std::pmr::vector<OptionDefinitionSP>;
+
+    //! Definitions are owned by m_optionDefinitions and shared with the copies of the schema. The lookups and the
+    //! parse state only refer to them, so that a parse doesn't touch the reference counts shared between threads.
+    using OptionDefinitionPtr = const OptionDefinition *;
 
-    template<typename CallbackType>
-    std::shared_ptr<OptionDefinition> addOptionCommon(const OptionSet & optionVariants, CallbackType callback, bool required, const std::string & infoText)
+    //! Error of a parse. Only the details are stored, so nothing is formatted until the message is requested.
+    //! The views refer to the arguments and the files of the parse, so the message can be formatted until the next parse.
+    struct Failure
     {
-        if (const auto existing = getOptionDefinition(optionVariants)) {
-            throwOptionExistingError(*existing);
-        } else {
-            const auto optionDefinition = std::make_shared<OptionDefinition>(optionVariants, callback, required, infoText);
-            m_optionDefinitions.push_back(optionDefinition);
-            return optionDefinition;
+        explicit Failure(std::pmr::memory_resource * resource)
+          : seen(resource)
+        {
+        }
+
+        enum class Reason
+        {
+            None,
+            EmptyArguments,
+            UnknownOption,
+            NoValue,
+            TooFewValues,
+            InvalidValue,
+            OutOfRange,
+            Conflict,
+            GroupIncomplete,
+            Required,
+            ResponseFileTooDeep,
+            ResponseFileUnreadable,
+            ResponseFileUnterminatedQuote,
+            ConfigFileUnreadable,
+            ConfigFileUnknownOption,
+            ConfigFileMalformed,
+            Subcommand
+        };
+
+        Reason reason = Reason::None;
+
+        Error::Code code = Error::Code::Ok;
+
+        OptionDefinitionPtr definition = nullptr;
+
+        //! The argument, the value, the key of the config file or the path of the response file.
+        std::string_view text;
+
+        //! Line of the config file or the conflicting option set or the option group.
+        size_t number = 0;
+
+        //! Given definitions of a conflict or an incomplete group.
+        Bitmask seen;
+
+        //! Message of a failed subcommand, as its instance is gone when the message is requested.
+        std::string message;
+    };
+
+    //! Sets the failure.
+    //! \return Always false, so that a failing step can return the result directly.
+    static bool fail(Failure & failure, Failure::Reason reason, OptionDefinitionPtr definition = nullptr, std::string_view text = {}, size_t number = 0)
+    {
+        failure.reason = reason;
+        failure.code = failureCode(reason);
+        failure.definition = definition;
+        failure.text = text;
+        failure.number = number;
+        return false;
+    }
+
+    static Error::Code failureCode(Failure::Reason reason)
+    {
+        switch (reason) {
+        case Failure::Reason::None:
+            return Error::Code::Ok;
+        case Failure::Reason::UnknownOption:
+        case Failure::Reason::ConfigFileUnknownOption:
+            return Error::Code::UnknownOption;
+        case Failure::Reason::NoValue:
+        case Failure::Reason::TooFewValues:
+            return Error::Code::MissingValue;
+        case Failure::Reason::InvalidValue:
+            return Error::Code::InvalidValue;
+        case Failure::Reason::OutOfRange:
+            return Error::Code::OutOfRange;
+        case Failure::Reason::Conflict:
+            return Error::Code::Conflict;
+        case Failure::Reason::GroupIncomplete:
+            return Error::Code::GroupIncomplete;
+        case Failure::Reason::Required:
+            return Error::Code::Required;
+        default:
+            return Error::Code::Failed;
+        }
+    }
+
+    //! Prefix trie of all option variants. Used to match the spaceless format (e.g. "-O3") in a single walk.
+    class VariantTrie
+    {
+    public:
+        explicit VariantTrie(std::pmr::memory_resource * resource)
+          : m_nodes(resource)
+        {
+            m_nodes.emplace_back();
+        }
+
+        VariantTrie(const VariantTrie & other, std::pmr::memory_resource * resource)
+          : m_nodes(other.m_nodes, resource)
+        {
+        }
+
+        struct Match
+        {
+            const OptionDefinition * definition = nullptr;
+
+            size_t length = 0;
+
+            bool ambiguous = false;
+        };
+
+        void insert(std::string_view variant, const OptionDefinition * definition)
+        {
+            size_t node = 0;
+            for (auto && c : variant) {
+                auto & edges = m_nodes.at(node).edges;
+                auto edge = std::lower_bound(edges.begin(), edges.end(), c, [](const Edge & edge, char c) {
+                    return edge.first < c;
+                });
+                if (edge == edges.end() || edge->first != c) {
+                    const auto child = m_nodes.size();
+                    edges.insert(edge, { c, child });
+                    m_nodes.emplace_back();
+                    node = child;
+                } else {
+                    node = edge->second;
+                }
+            }
+            m_nodes.at(node).definition = definition;
+        }
+
+        //! \return The definition of the longest variant that is a prefix of arg. The match is ambiguous if
+        //!         the variants found along the way belong to more than one definition.
+        Match longestPrefix(std::string_view arg) const
+        {
+            Match match;
+            size_t node = 0;
+            size_t depth = 0;
+            while (true) {
+                if (const auto definition = m_nodes[node].definition) {
+                    match.ambiguous = match.ambiguous || (match.definition && match.definition != definition);
+                    match.definition = definition;
+                    match.length = depth;
+                }
+                if (depth == arg.size()) {
+                    break;
+                }
+                const auto & edges = m_nodes[node].edges;
+                const auto edge = std::lower_bound(edges.begin(), edges.end(), arg[depth], [](const Edge & edge, char c) {
+                    return edge.first < c;
+                });
+                if (edge == edges.end() || edge->first != arg[depth]) {
+                    break;
+                }
+                node = edge->second;
+                depth++;
+            }
+            return match;
+        }
+
+    private:
+        using Edge = std::pair<char, size_t>;
+
+        //! Allocator-aware so that the edges are allocated from the resource of the trie.
+        struct Node
+        {
+            using allocator_type = std::pmr::polymorphic_allocator<Node>;
+
+            explicit Node(const allocator_type & allocator)
+              : edges(allocator)
+            {
+            }
+
+            Node(const Node & other, const allocator_type & allocator)
+              : edges(other.edges, allocator)
+              , definition(other.definition)
+            {
+            }
+
+            Node(Node && other, const allocator_type & allocator)
+              : edges(std::move(other.edges), allocator)
+              , definition(other.definition)
+            {
+            }
+
+            std::pmr::vector<Edge> edges;
+
+            const OptionDefinition * definition = nullptr;
+        };
+
+        std::pmr::vector<Node> m_nodes;
+    };
+
+    //! Conflicting options or option groups compiled into bitmasks of definition ids. An inverted index from
+    //! definition id to the sets containing it allows checking only the sets touched by the given options.
+    class ConstraintSets
+    {
+    public:
+        explicit ConstraintSets(std::pmr::memory_resource * resource)
+          : m_optionSets(resource)
+          , m_masks(resource)
+          , m_totals(resource)
+          , m_indexOffsets(resource)
+          , m_index(resource)
+        {
+        }
+
+        ConstraintSets(const ConstraintSets & other, std::pmr::memory_resource * resource)
+          : m_optionSets(other.m_optionSets, resource)
+          , m_words(other.m_words)
+          , m_masks(other.m_masks, resource)
+          , m_totals(other.m_totals, resource)
+          , m_indexOffsets(other.m_indexOffsets, resource)
+          , m_index(other.m_index, resource)
+        {
+        }
+
+        void add(const OptionSet & optionSet)
+        {
+            m_optionSets.emplace_back(optionSet.begin(), optionSet.end());
+        }
+
+        //! Resolves the options of the sets to definition ids and builds the masks and the index.
+        void finalize(const Schema & schema)
+        {
+            const auto definitionCount = schema.optionDefinitionCount();
+            m_words = bitmaskWordCount(definitionCount);
+            m_masks.assign(m_optionSets.size() * m_words, 0);
+            m_totals.assign(m_optionSets.size(), 0);
+            m_indexOffsets.assign(definitionCount + 1, 0);
+            for (size_t set = 0; set < m_optionSets.size(); set++) {
+                const auto mask = m_masks.data() + set * m_words;
+                for (auto && option : m_optionSets.at(set)) {
+                    if (const auto definition = schema.getOptionDefinition(std::string_view { option })) {
+                        if (!testBit(mask, definition->id)) {
+                            setBit(mask, definition->id);
+                            m_indexOffsets.at(definition->id + 1)++;
+                            m_totals.at(set)++;
+                        }
+                    } else {
+                        // An unknown option can never be given, so it's always missing from a group
+                        m_totals.at(set)++;
+                    }
+                }
+            }
+
+            for (size_t id = 0; id < definitionCount; id++) {
+                m_indexOffsets.at(id + 1) += m_indexOffsets.at(id);
+            }
+            m_index.resize(m_indexOffsets.back());
+            auto cursors = m_indexOffsets;
+            for (size_t set = 0; set < m_optionSets.size(); set++) {
+                forEachSetBit(m_masks.data() + set * m_words, m_words, [&](size_t id) {
+                    m_index.at(cursors.at(id)++) = set;
+                });
+            }
+        }
+
+        //! Calls function(set, seenCount) in the order of addition for each set that contains at least one
+        //! of the seen definitions. seenCount is the number of seen definitions in the set.
+        template<typename Function>
+        void forEachTouchedSet(const Bitmask & seen, std::pmr::memory_resource * resource, Function && function) const
+        {
+            if (m_optionSets.empty()) {
+                return;
+            }
+
+            Bitmask touched(bitmaskWordCount(m_optionSets.size()), 0, resource);
+            forEachSetBit(seen.data(), m_words, [&](size_t id) {
+                for (auto set = m_indexOffsets.at(id); set < m_indexOffsets.at(id + 1); set++) {
+                    setBit(touched.data(), m_index.at(set));
+                }
+            });
+
+            forEachSetBit(touched.data(), touched.size(), [&](size_t set) {
+                const auto mask = m_masks.data() + set * m_words;
+                size_t seenCount = 0;
+                for (size_t i = 0; i < m_words; i++) {
+                    seenCount += countBits(mask[i] & seen[i]);
+                }
+                function(set, seenCount);
+            });
+        }
+
+        const VariantSet & optionSet(size_t set) const
+        {
+            return m_optionSets.at(set);
+        }
+
+        //! \return Number of distinct options in the set. Variants of the same option are counted once.
+        size_t total(size_t set) const
+        {
+            return m_totals.at(set);
+        }
+
+        //! \return Options of the set whose definitions have (or have not) been seen.
+        OptionSet filter(const Schema & schema, size_t set, const Bitmask & seen, bool wasSeen) const
+        {
+            OptionSet options;
+            for (auto && option : m_optionSets.at(set)) {
+                const auto definition = schema.getOptionDefinition(std::string_view { option });
+                if ((definition && testBit(seen.data(), definition->id)) == wasSeen) {
+                    options.insert(std::string { option });
+                }
+            }
+            return options;
+        }
+
+    private:
+        std::pmr::vector<VariantSet> m_optionSets;
+
+        //! Words per mask.
+        size_t m_words = 0;
+
+        //! Masks of all sets, m_words per set.
+        Bitmask m_masks;
+
+        std::pmr::vector<size_t> m_totals;
+
+        //! Index of the sets containing a definition: m_index[m_indexOffsets[id]..m_indexOffsets[id + 1]).
+        std::pmr::vector<size_t> m_indexOffsets;
+
+        std::pmr::vector<size_t> m_index;
+    };
+
+    OptionDefinitionSP addOption(const OptionSet & optionVariants, ValuelessCallback callback, bool required, const std::string & infoText)
+    {
+        return addOptionCommon(optionVariants, callback, required, infoText);
+    }
+
+    OptionDefinitionSP addOption(const OptionSet & optionVariants, SingleStringCallback callback, bool required, const std::string & infoText, const std::string & valueName)
+    {
+        return addOptionCommon(optionVariants, callback, required, infoText, valueName);
+    }
+
+    OptionDefinitionSP addOption(const OptionSet & optionVariants, SingleStringViewCallback callback, bool required, const std::string & infoText, const std::string & valueName)
+    {
+        return addOptionCommon(optionVariants, callback, required, infoText, valueName);
+    }
+
+    OptionDefinitionSP addOption(const OptionSet & optionVariants, Arity arity, MultiStringViewCallback callback, bool required, const std::string & infoText, const std::string & valueName)
+    {
+        const auto od = addOptionCommon(optionVariants, callback, required, infoText, valueName);
+        od->arity = arity;
+        od->multiValueId = m_multiValueOptionCount++;
+        return od;
+    }
+
+    bool hasMultiValueOptions() const
+    {
+        return m_multiValueOptionCount > 0;
+    }
+
+    size_t multiValueOptionCount() const
+    {
+        return m_multiValueOptionCount;
+    }
+
+    template<typename T>
+    OptionDefinitionSP addTypedOption(const OptionSet & optionVariants, std::function<void(T)> callback, ValueRange<T> range, bool required, const std::string & infoText, const std::string & valueName)
+    {
+        const auto od = addOptionCommon(optionVariants, callback, required, infoText, valueName);
+        if constexpr (std::is_same_v<T, int64_t>) {
+            od->int64Range = range;
+        } else if constexpr (std::is_same_v<T, double>) {
+            od->doubleRange = range;
+        }
+        return od;
+    }
+
+    //! Converts the value of a typed option. The value is std::monostate if the option is not typed.
+    //! \return False on an invalid value or a value out of range.
+    bool convertValue(const OptionDefinition & definition, std::string_view value, TypedValue & typedValue, Failure & failure) const
+    {
+        if (definition.int64Callback) {
+            return convertNumber(definition, value, definition.int64Range, typedValue, failure);
+        }
+        if (definition.doubleCallback) {
+            return convertNumber(definition, value, definition.doubleRange, typedValue, failure);
+        }
+        if (definition.boolCallback) {
+            if (value == "1" || value == "true" || value == "yes" || value == "on") {
+                typedValue = true;
+            } else if (value == "0" || value == "false" || value == "no" || value == "off") {
+                typedValue = false;
+            } else {
+                return fail(failure, Failure::Reason::InvalidValue, &definition, value);
+            }
+        }
+        return true;
+    }
+
+    //! Adds the default help. It has no callback as the help is printed by the parsing instance.
+    void addHelp(std::string_view applicationName)
+    {
+        m_helpText = "Usage: ";
+        m_helpText += applicationName;
+        m_helpText += " [OPTIONS]";
+        m_helpRendered = false;
+
+        constexpr std::array<std::string_view, 2> helpVariants = { "-h", "--help" };
+        const auto helpDefinition = addOptionCommon(helpVariants, ValuelessCallback {}, false, SHOW_THIS_HELP_TEXT);
+
+        helpDefinition->isHelp = true;
+    }
+
+    void addConflictingOptions(const OptionSet & conflictingOptionSet)
+    {
+        m_conflictingOptionSets.add(conflictingOptionSet);
+        m_finalized = false;
+    }
+
+    void addOptionGroup(const OptionSet & optionGroup)
+    {
+        m_optionGroupSets.add(optionGroup);
+        m_finalized = false;
+    }
+
+    //! Replaces the text at the start of the rendered help, if any.
+    void setHelpText(const std::string & helpText)
+    {
+        m_helpText = helpText;
+        if (m_helpRendered) {
+            const auto headerLength = m_helpText.empty() ? 0 : m_helpText.size() + 2;
+            m_renderedHelp.replace(0, m_helpHeaderLength, m_helpText);
+            if (!m_helpText.empty()) {
+                m_renderedHelp.insert(m_helpText.size(), "\n\n");
+            }
+            for (auto && line : m_helpLines) {
+                line.offset = line.offset + headerLength - m_helpHeaderLength;
+            }
+            m_helpOptionsEnd = m_helpOptionsEnd + headerLength - m_helpHeaderLength;
+            m_helpHeaderLength = headerLength;
+        }
+    }
+
+    std::string helpText() const
+    {
+        return std::string { m_helpText };
+    }
+
+    //! The help is rendered again as all lines move.
+    void setHelpSorting(HelpSorting helpSorting)
+    {
+        if (m_helpSorting != helpSorting) {
+            m_helpSorting = helpSorting;
+            m_helpRendered = false;
+        }
+    }
+
+    void setPositionalArgumentCallback(MultiStringCallback callback)
+    {
+        m_positionalArgumentCallback = callback;
+        m_positionalArgumentViewCallback = nullptr;
+        m_positionalArgumentBatchSize = 0;
+    }
+
+    void setPositionalArgumentCallback(MultiStringViewCallback callback, size_t batchSize)
+    {
+        m_positionalArgumentViewCallback = callback;
+        m_positionalArgumentCallback = nullptr;
+        m_positionalArgumentBatchSize = batchSize;
+    }
+
+    //! \return Number of positional arguments passed to the callback at a time or 0 if all are passed at once.
+    size_t positionalArgumentBatchSize() const
+    {
+        return m_positionalArgumentBatchSize;
+    }
+
+    bool hasPositionalArgumentCallback() const
+    {
+        return m_positionalArgumentCallback || m_positionalArgumentViewCallback;
+    }
+
+    void processPositionalArguments(const ArgumentViewVector & positionalArguments) const
+    {
+        if (m_positionalArgumentViewCallback) {
+            m_positionalArgumentViewCallback({ positionalArguments.data(), positionalArguments.size() });
+        } else if (m_positionalArgumentCallback) {
+            m_positionalArgumentCallback({ positionalArguments.begin(), positionalArguments.end() });
+        }
+    }
+
+    size_t optionDefinitionCount() const
+    {
+        return m_optionDefinitions.size();
+    }
+
+    //! \return True if the help is rendered for the current options and help text.
+    bool isHelpRendered() const
+    {
+        return m_helpRendered;
+    }
+
+    //! Lays out the help into a single buffer. Added options and subcommands and a new help text are updated in place
+    //! afterwards, see addHelpLine(), addSubcommandHelpLine() and setHelpText(). The help is rendered again only if
+    //! the argument column must grow or the sorting changes.
+    void renderHelp()
+    {
+        size_t maxLength = 0;
+        size_t helpTextLength = 0;
+        std::pmr::vector<OptionDefinitionPtr> options { m_resource };
+        options.reserve(m_optionDefinitions.size());
+        for (auto && option : m_optionDefinitions) {
+            maxLength = std::max(helpArgumentLength(*option), maxLength);
+            helpTextLength += option->infoText.size();
+            options.push_back(option.get());
+        }
+
+        for (auto && subcommand : m_subcommands) {
+            maxLength = std::max(subcommand.name.size(), maxLength);
+            helpTextLength += subcommand.name.size() + subcommand.infoText.size();
+        }
+
+        if (m_helpSorting == HelpSorting::Ascending) {
+            std::sort(options.begin(), options.end(), [](OptionDefinitionPtr l, OptionDefinitionPtr r) {
+                return l->variantsString < r->variantsString;
+            });
+        }
+
+        m_helpColumn = maxLength + HelpMargin;
+        m_helpHeaderLength = m_helpText.empty() ? 0 : m_helpText.size() + 2;
+        m_renderedHelp.clear();
+        m_renderedHelp.reserve(m_helpHeaderLength + HelpOptionsTitle.size() + HelpCommandsTitle.size() + (options.size() + m_subcommands.size()) * (m_helpColumn + 1) + helpTextLength + 2);
+        if (!m_helpText.empty()) {
+            m_renderedHelp += m_helpText;
+            m_renderedHelp += "\n\n";
+        }
+
+        m_renderedHelp += HelpOptionsTitle;
+        m_helpLines.clear();
+        for (auto && option : options) {
+            m_helpLines.push_back(appendHelpLine(*option));
+        }
+        m_helpOptionsEnd = m_renderedHelp.size();
+        m_renderedHelp += '\n';
+
+        if (!m_subcommands.empty()) {
+            m_renderedHelp += HelpCommandsTitle;
+            for (auto && subcommand : m_subcommands) {
+                appendHelpLine(subcommand.name, subcommand.infoText);
+            }
+            m_renderedHelp += '\n';
+        }
+
+        m_helpRendered = true;
+    }
+
+    //! \return The option for the config key, i.e. a variant without the leading dashes, or nullptr.
+    OptionDefinitionPtr getOptionDefinitionForConfigKey(std::string_view key) const
+    {
+        const auto item = m_configKeyIndex.find(stripDashes(key));
+        return item != m_configKeyIndex.end() ? item->second : nullptr;
+    }
+
+    void bindEnvironmentVariable(const std::string & option, const std::string & variable)
+    {
+        if (const auto definition = getOptionDefinition(std::string_view { option })) {
+            // Names in a deque are never moved, so the views in the index stay valid
+            m_environmentVariables.emplace_back(variable, definition);
+            m_environmentVariableIndex[m_environmentVariables.back().first] = definition;
+        } else {
+            throwError(unknownOptionMessage(option));
+        }
+    }
+
+    bool hasEnvironmentVariables() const
+    {
+        return !m_environmentVariableIndex.empty();
+    }
+
+    //! \return The option bound to the environment variable "NAME=value" or nullptr.
+    OptionDefinitionPtr getOptionDefinitionForEnvironmentVariable(std::string_view name) const
+    {
+        const auto item = m_environmentVariableIndex.find(name);
+        return item != m_environmentVariableIndex.end() ? item->second : nullptr;
+    }
+
+    //! Allocator-aware so that the name and the info text are allocated from the resource of the schema.
+    struct Subcommand
+    {
+        using allocator_type = std::pmr::polymorphic_allocator<Subcommand>;
+
+        Subcommand(std::string_view name, SubcommandFactory factory, std::string_view infoText, const allocator_type & allocator)
+          : name(name, allocator)
+          , factory(factory)
+          , infoText(infoText, allocator)
+        {
+        }
+
+        Subcommand(const Subcommand & other, const allocator_type & allocator)
+          : name(other.name, allocator)
+          , factory(other.factory)
+          , infoText(other.infoText, allocator)
+        {
+        }
+
+        std::pmr::string name;
+
+        SubcommandFactory factory;
+
+        std::pmr::string infoText;
+    };
+
+    void addSubcommand(const std::string & name, SubcommandFactory factory, const std::string & infoText)
+    {
+        if (getSubcommand(name)) {
+            throwError(Schema::name() + ": Subcommand '" + name + "' already defined!");
+        }
+        // Names in a deque are never moved, so the views in the index stay valid
+        m_subcommands.emplace_back(name, factory, infoText);
+        m_subcommandIndex[m_subcommands.back().name] = &m_subcommands.back();
+        addSubcommandHelpLine(m_subcommands.back());
+    }
+
+    bool hasSubcommands() const
+    {
+        return !m_subcommandIndex.empty();
+    }
+
+    //! \return The subcommand of the given name or nullptr.
+    const Subcommand * getSubcommand(std::string_view name) const
+    {
+        const auto item = m_subcommandIndex.find(name);
+        return item != m_subcommandIndex.end() ? item->second : nullptr;
+    }
+
+    //! \return Index of the first argument before "--" that is a subcommand and not a value of an option, or 0 if there's none.
+    //! \param lookups Incremented by the number of lookups.
+    size_t findSubcommand(const ArgumentViewVector & args, size_t & lookups) const
+    {
+        for (size_t i = 1; i < args.size() && args.at(i) != EndOfOptions; i++) {
+            lookups++;
+            if (const auto definition = getOptionDefinition(args.at(i))) {
+                if (definition->hasValue() && !definition->isMultiValue()) {
+                    i++;
+                }
+            } else if (getSubcommand(args.at(i))) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    void setHelpSection(const std::string & section)
+    {
+        m_helpSection = section;
+    }
+
+    //! Prints help for the options matching the filter, see Argengine::printHelp(std::string_view). The matching lines
+    //! are written from the rendered help as they are, so the help must be rendered.
+    void printHelp(std::ostream & out, std::string_view filter) const
+    {
+        const auto exactMatch = getOptionDefinition(filter);
+        const bool isSection = !exactMatch && std::any_of(m_helpLines.begin(), m_helpLines.end(), [&](const HelpLine & line) {
+            return line.definition->section == filter;
+        });
+        const bool isGlob = filter.find_first_of("*?") != std::string_view::npos;
+        const auto matches = [&](const OptionDefinition & definition) {
+            if (exactMatch) {
+                return &definition == exactMatch;
+            }
+            if (isSection) {
+                return definition.section == filter;
+            }
+            return std::any_of(definition.variants.begin(), definition.variants.end(), [&](const std::pmr::string & variant) {
+                return isGlob ? globMatch(filter, variant) : std::string_view { variant }.find(filter) != std::string_view::npos;
+            });
+        };
+
+        bool matched = false;
+        for (auto && line : m_helpLines) {
+            if (matches(*line.definition)) {
+                if (!matched) {
+                    out << "Options matching '" << filter << "':\n\n";
+                    matched = true;
+                }
+                out.write(m_renderedHelp.data() + line.offset, static_cast<std::streamsize>(line.length));
+            }
+        }
+
+        if (matched) {
+            out << '\n';
+        } else {
+            out << "No options matching '" << filter << "'.\n";
+        }
+        out.flush();
+    }
+
+    //! Writes the rendered help in a single write.
+    void printHelp(std::ostream & out) const
+    {
+        out.write(m_renderedHelp.data(), static_cast<std::streamsize>(m_renderedHelp.size()));
+        out.flush();
+    }
+
+    template<typename Variants>
+    OptionDefinitionPtr getOptionDefinition(const Variants & variants) const
+    {
+        for (auto && variant : variants) {
+            if (const auto definition = getOptionDefinition(std::string_view { variant })) {
+                return definition;
+            }
+        }
+        return nullptr;
+    }
+
+    OptionDefinitionPtr getOptionDefinition(std::string_view argument) const
+    {
+        const auto item = m_optionIndex.find(argument);
+        return item != m_optionIndex.end() ? item->second : nullptr;
+    }
+
+    //! \return Views to the given arguments. Arguments in the assignment and spaceless formats are split into two tokens.
+    //! \param resource Memory resource for the tokens.
+    //! \param lookups Incremented by the number of definition lookups.
+    //! \param helpFilter Set to the value of the default help given in the assignment format, i.e. "--help=FILTER".
+    ArgumentViewVector tokenize(const ArgumentViewVector & args, std::pmr::memory_resource * resource, size_t & lookups, std::string_view & helpFilter) const
+    {
+        ArgumentViewVector tokens { resource };
+        tokens.reserve(args.size());
+
+        for (auto arg = args.begin(); arg != args.end(); arg++) {
+            if (*arg == EndOfOptions) {
+                tokens.insert(tokens.end(), arg, args.end());
+                break;
+            }
+            if (const auto assignmentTokens = splitAssignmentFormat(*arg, lookups, helpFilter); !assignmentTokens.first.empty()) {
+                tokens.push_back(assignmentTokens.first);
+                if (!assignmentTokens.second.empty()) {
+                    tokens.push_back(assignmentTokens.second);
+                }
+            } else {
+                if (const auto spacelessTokens = splitSpacelessFormat(*arg, lookups); !spacelessTokens.first.empty()) {
+                    tokens.push_back(spacelessTokens.first);
+                    if (!spacelessTokens.second.empty()) {
+                        tokens.push_back(spacelessTokens.second);
+                    }
+                } else {
+                    tokens.push_back(*arg);
+                }
+            }
+        }
+
+        return tokens;
+    }
+
+    //! \return Number of words in a bitmask of definition ids.
+    size_t bitmaskWords() const
+    {
+        return bitmaskWordCount(m_optionDefinitions.size());
+    }
+
+    //! \return True if the constraints have been compiled for the current definitions.
+    bool isFinalized() const
+    {
+        return m_finalized;
+    }
+
+    //! Compiles the conflicting options, option groups and required options into bitmasks. Done lazily as the
+    //! constraints may refer to options that are added after them.
+    void finalize()
+    {
+        m_conflictingOptionSets.finalize(*this);
+        m_optionGroupSets.finalize(*this);
+        m_configKeyIndex.clear();
+        for (auto && definition : m_optionDefinitions) {
+            for (auto && variant : definition->variants) {
+                // The keys are views to the variants owned by the definition
+                m_configKeyIndex.insert({ stripDashes(variant), definition.get() });
+            }
+        }
+        m_requiredMask.assign(bitmaskWords(), 0);
+        for (auto && definition : m_optionDefinitions) {
+            if (definition->required) {
+                setBit(m_requiredMask.data(), definition->id);
+            }
+        }
+        m_finalized = true;
+    }
+
+    //! \param seen Bitmask of the given definitions.
+    //! \return False if options of a conflicting option set were given.
+    bool checkConflictingOptions(const Bitmask & seen, std::pmr::memory_resource * resource, Failure & failure) const
+    {
+        m_conflictingOptionSets.forEachTouchedSet(seen, resource, [&](size_t set, size_t seenCount) {
+            if (seenCount > 1 && failure.reason == Failure::Reason::None) {
+                fail(failure, Failure::Reason::Conflict, nullptr, {}, set);
+                failure.seen.assign(seen.begin(), seen.end());
+            }
+        });
+        return failure.reason == Failure::Reason::None;
+    }
+
+    //! \param seen Bitmask of the given definitions.
+    //! \return False if only some options of an option group were given.
+    bool checkOptionGroups(const Bitmask & seen, std::pmr::memory_resource * resource, Failure & failure) const
+    {
+        m_optionGroupSets.forEachTouchedSet(seen, resource, [&](size_t set, size_t seenCount) {
+            if (seenCount < m_optionGroupSets.total(set) && failure.reason == Failure::Reason::None) {
+                fail(failure, Failure::Reason::GroupIncomplete, nullptr, {}, set);
+                failure.seen.assign(seen.begin(), seen.end());
+            }
+        });
+        return failure.reason == Failure::Reason::None;
+    }
+
+    //! \param seen Bitmask of the given definitions.
+    //! \return False if a required option was not given.
+    bool checkRequired(const Bitmask & seen, Failure & failure) const
+    {
+        for (size_t i = 0; i < m_requiredMask.size(); i++) {
+            if (const auto missing = m_requiredMask.at(i) & ~seen.at(i)) {
+                return fail(failure, Failure::Reason::Required, m_optionDefinitions.at(i * BitsPerWord + countTrailingZeros(missing)).get());
+            }
+        }
+        return true;
+    }
+
+    static std::string name()
+    {
+        return "Argengine";
+    }
+
+    static std::string unknownOptionMessage(std::string_view arg)
+    {
+        return name() + ": Unknown option '" + std::string { arg } + "'!";
+    }
+
+    //! Formats the message of the failure.
+    //! \param configFilePath Path of the config file of the parse.
+    std::string failureMessage(const Failure & failure, std::string_view configFilePath) const
+    {
+        const auto configFile = [&](const std::string & reason) {
+            return name() + ": Config file '" + std::string { configFilePath } + "' line " + std::to_string(failure.number) + ": " + reason + "!";
+        };
+        const auto responseFile = [&](const std::string & reason) {
+            return name() + ": Response file '" + std::string { failure.text } + "' " + reason + "!";
+        };
+
+        switch (failure.reason) {
+        case Failure::Reason::None:
+            return {};
+        case Failure::Reason::EmptyArguments:
+            return name() + ": Argument vector is empty!";
+        case Failure::Reason::UnknownOption:
+            return unknownOptionMessage(failure.text);
+        case Failure::Reason::NoValue:
+            return name() + ": No value for option '" + std::string { failure.definition->variantsString } + "' given!";
+        case Failure::Reason::TooFewValues: {
+            const auto & arity = failure.definition->arity;
+            const auto expected = arity.min == arity.max ? std::to_string(arity.min) : "at least " + std::to_string(arity.min);
+            return name() + ": Too few values for option '" + std::string { failure.definition->variantsString } + "' given! Expected " + expected + ".";
+        }
+        case Failure::Reason::InvalidValue:
+            return name() + ": Invalid value '" + std::string { failure.text } + "' for option '" + std::string { failure.definition->variantsString } + "'!";
+        case Failure::Reason::OutOfRange: {
+            std::ostringstream range;
+            if (failure.definition->int64Callback) {
+                range << "[" << failure.definition->int64Range.min << ", " << failure.definition->int64Range.max << "]";
+            } else {
+                range << "[" << failure.definition->doubleRange.min << ", " << failure.definition->doubleRange.max << "]";
+            }
+            return name() + ": Value '" + std::string { failure.text } + "' for option '" + std::string { failure.definition->variantsString } + "' is out of range " + range.str() + "!";
+        }
+        case Failure::Reason::Conflict:
+            return name() + ": Conflicting options: " + optionSetToString(m_conflictingOptionSets.filter(*this, failure.number, failure.seen, true)) + ". These options cannot coexist.";
+        case Failure::Reason::GroupIncomplete:
+            return name() + ": These options must coexist: " + optionSetToString(m_optionGroupSets.optionSet(failure.number)) + ". Missing options: " + optionSetToString(m_optionGroupSets.filter(*this, failure.number, failure.seen, false)) + ".";
+        case Failure::Reason::Required:
+            return name() + ": Option '" + std::string { failure.definition->variantsString } + "' is required!";
+        case Failure::Reason::ResponseFileTooDeep:
+            return responseFile("is nested too deeply");
+        case Failure::Reason::ResponseFileUnreadable:
+            return responseFile("cannot be read");
+        case Failure::Reason::ResponseFileUnterminatedQuote:
+            return responseFile("has an unterminated quote");
+        case Failure::Reason::ConfigFileUnreadable:
+            return name() + ": Config file '" + std::string { configFilePath } + "' cannot be read!";
+        case Failure::Reason::ConfigFileUnknownOption:
+            return configFile("Unknown option '" + std::string { failure.text } + "'");
+        case Failure::Reason::ConfigFileMalformed:
+            return configFile("Expected 'key = value'");
+        case Failure::Reason::Subcommand:
+            return failure.message;
+        }
+        return {};
+    }
+
+    void setResponseFileExpansion(bool responseFileExpansion)
+    {
+        m_responseFileExpansion = responseFileExpansion;
+    }
+
+    bool responseFileExpansion() const
+    {
+        return m_responseFileExpansion;
+    }
+
+private:
+    template<typename Variants, typename CallbackType>
+    OptionDefinitionSP addOptionCommon(const Variants & optionVariants, CallbackType callback, bool required, std::string_view infoText, std::string_view valueName = "VALUE")
+    {
+        if (const auto existing = getOptionDefinition(optionVariants)) {
+            throwOptionExistingError(*existing);
+        } else {
+            const auto optionDefinition = std::allocate_shared<OptionDefinition>(std::pmr::polymorphic_allocator<OptionDefinition> { m_resource }, optionVariants, callback, required, infoText, m_resource);
+            optionDefinition->id = m_optionDefinitions.size();
+            optionDefinition->section = m_helpSection;
+            optionDefinition->variantsString = optionDefinition->buildVariantsString();
+            optionDefinition->valueName = valueName;
+            m_finalized = false;
+            addHelpLine(*optionDefinition);
+            m_optionDefinitions.push_back(optionDefinition);
+            // The keys are views to the variants owned by the definition. Nodes of std::set are stable, so the views stay valid.
+            for (auto && variant : optionDefinition->variants) {
+                m_optionIndex[variant] = optionDefinition.get();
+                m_variantTrie.insert(variant, optionDefinition.get());
+            }
+            return optionDefinition;
+        }
+    }
+
+    //! \return Length of the variants and the value name of the option in the help, e.g. "-f, --foo [VALUE]".
+    static size_t helpArgumentLength(const OptionDefinition & option)
+    {
+        return option.variantsString.size() + (option.hasValue() ? option.valueName.size() + (option.isMultiValue() ? 6 : 3) : 0);
+    }
+
+    //! Line of an option in the rendered help.
+    struct HelpLine
+    {
+        OptionDefinitionPtr definition = nullptr;
+
+        size_t offset = 0;
+
+        //! Length including the newline.
+        size_t length = 0;
+    };
+
+    //! Appends the line of the option, padded to the argument column, to the rendered help.
+    HelpLine appendHelpLine(const OptionDefinition & option)
+    {
+        const auto offset = m_renderedHelp.size();
+        m_renderedHelp += option.variantsString;
+        if (option.hasValue()) {
+            m_renderedHelp += " [";
+            m_renderedHelp += option.valueName;
+            m_renderedHelp += option.isMultiValue() ? "...]" : "]";
+        }
+        m_renderedHelp.append(m_helpColumn - (m_renderedHelp.size() - offset), ' ');
+        m_renderedHelp += option.infoText;
+        m_renderedHelp += '\n';
+        return { &option, offset, m_renderedHelp.size() - offset };
+    }
+
+    //! Appends the line of a subcommand, padded to the argument column, to the rendered help.
+    void appendHelpLine(std::string_view name, std::string_view infoText)
+    {
+        m_renderedHelp += name;
+        m_renderedHelp.append(m_helpColumn - name.size(), ' ');
+        m_renderedHelp += infoText;
+        m_renderedHelp += '\n';
+    }
+
+    //! Inserts the line of a new option into the rendered help, if any, without rendering the other lines.
+    void addHelpLine(const OptionDefinition & option)
+    {
+        if (!m_helpRendered) {
+            return;
+        }
+        if (helpArgumentLength(option) + HelpMargin > m_helpColumn) {
+            m_helpRendered = false;
+            return;
+        }
+        auto position = m_helpLines.end();
+        if (m_helpSorting == HelpSorting::Ascending) {
+            position = std::upper_bound(m_helpLines.begin(), m_helpLines.end(), option.variantsString, [](const std::pmr::string & variants, const HelpLine & line) {
+                return variants < line.definition->variantsString;
+            });
+        }
+        const auto offset = position == m_helpLines.end() ? m_helpOptionsEnd : position->offset;
+        const auto end = m_renderedHelp.size();
+        auto line = appendHelpLine(option);
+        // The line is appended and then rotated into place, so no temporary string is needed
+        std::rotate(m_renderedHelp.begin() + static_cast<std::ptrdiff_t>(offset), m_renderedHelp.begin() + static_cast<std::ptrdiff_t>(end), m_renderedHelp.end());
+        line.offset = offset;
+        for (auto next = position; next != m_helpLines.end(); next++) {
+            next->offset += line.length;
+        }
+        m_helpOptionsEnd += line.length;
+        m_helpLines.insert(position, line);
+    }
+
+    //! Appends the line of a new subcommand to the rendered help, if any, without rendering the other lines.
+    void addSubcommandHelpLine(const Subcommand & subcommand)
+    {
+        if (!m_helpRendered) {
+            return;
+        }
+        if (subcommand.name.size() + HelpMargin > m_helpColumn) {
+            m_helpRendered = false;
+            return;
+        }
+        if (m_subcommands.size() == 1) {
+            m_renderedHelp += HelpCommandsTitle;
+            appendHelpLine(subcommand.name, subcommand.infoText);
+            m_renderedHelp += '\n';
+        } else {
+            // Before the empty line that ends the commands
+            const auto end = m_renderedHelp.size();
+            appendHelpLine(subcommand.name, subcommand.infoText);
+            std::rotate(m_renderedHelp.begin() + static_cast<std::ptrdiff_t>(end - 1), m_renderedHelp.begin() + static_cast<std::ptrdiff_t>(end), m_renderedHelp.end());
+        }
+    }
+
+    template<typename T>
+    bool convertNumber(const OptionDefinition & definition, std::string_view value, const ValueRange<T> & range, TypedValue & typedValue, Failure & failure) const
+    {
+        T number {};
+        const auto end = value.data() + value.size();
+        const auto result = std::from_chars(value.data(), end, number);
+        if (result.ec == std::errc::result_out_of_range) {
+            return fail(failure, Failure::Reason::OutOfRange, &definition, value);
+        }
+        if (result.ec != std::errc {} || result.ptr != end) {
+            return fail(failure, Failure::Reason::InvalidValue, &definition, value);
+        }
+        // NaN is never a valid value. Infinity is, but only if the range includes it.
+        if constexpr (std::is_floating_point_v<T>) {
+            if (std::isnan(number)) {
+                return fail(failure, Failure::Reason::InvalidValue, &definition, value);
+            }
+        }
+        if (!(number >= range.min && number <= range.max)) {
+            return fail(failure, Failure::Reason::OutOfRange, &definition, value);
+        }
+        typedValue = number;
+        return true;
+    }
+
+    using ArgumentAndValue = std::pair<std::string_view, std::string_view>;
+
+    //! \param helpFilter Set to the value of the default help, which is taken only in this format.
+    ArgumentAndValue splitAssignmentFormat(std::string_view arg, size_t & lookups, std::string_view & helpFilter) const
+    {
+        if (const auto pos = arg.find('='); pos != arg.npos) {
+            lookups++;
+            if (const auto match = getOptionDefinition(arg.substr(0, pos)); match && match->hasValue()) {
+                const auto assignmentFormatArg = arg.substr(0, pos);
+                if (const auto valueLength = arg.size() - (pos + 1); !valueLength) {
+                    return { assignmentFormatArg, "" };
+                } else {
+                    return { assignmentFormatArg, arg.substr(pos + 1, valueLength) };
+                }
+            } else if (match && match->isHelp && !match->valuelessCallback) {
+                helpFilter = arg.substr(pos + 1);
+                return { arg.substr(0, pos), "" };
+            }
+        }
+        return {};
+    }
+
+    ArgumentAndValue splitSpacelessFormat(std::string_view arg, size_t & lookups) const
+    {
+        lookups++;
+        if (const auto match = m_variantTrie.longestPrefix(arg); match.definition && !match.ambiguous && match.definition->hasValue()) {
+            if (const auto valueLength = arg.size() - match.length; !valueLength) {
+                return { arg, "" };
+            } else {
+                return { arg.substr(0, match.length), arg.substr(match.length, valueLength) };
+            }
+        }
+        return {};
+    }
+
+    template<typename Options>
+    std::string optionSetToString(const Options & options) const
+    {
+        std::string optionsString;
+        for (auto && option : options) {
+            if (!optionsString.empty() && optionsString.back() == '\'') {
+                optionsString += ", ";
+            }
+            optionsString += "'" + std::string { option } + "'";
+        }
+        return optionsString;
+    }
+
+    [[noreturn]] void throwOptionExistingError(const OptionDefinition & existing) const
+    {
+        throwError(name() + ": Option '" + std::string { existing.variantsString } + "' already defined!");
+    }
+
+    std::pmr::memory_resource * m_resource;
+
+    std::pmr::string m_helpText;
+
+    HelpSorting m_helpSorting = HelpSorting::None;
+
+    OptionDefinitionVector m_optionDefinitions;
+
+    std::pmr::unordered_map<std::string_view, OptionDefinitionPtr> m_optionIndex;
+
+    VariantTrie m_variantTrie;
+
+    ConstraintSets m_conflictingOptionSets;
+
+    ConstraintSets m_optionGroupSets;
+
+    Bitmask m_requiredMask;
+
+    //! Names of the bound environment variables and their options.
+    std::pmr::deque<std::pair<std::pmr::string, OptionDefinitionPtr>> m_environmentVariables;
+
+    std::pmr::unordered_map<std::string_view, OptionDefinitionPtr> m_environmentVariableIndex;
+
+    //! Options by variants without the leading dashes. Built by finalize().
+    std::pmr::unordered_map<std::string_view, OptionDefinitionPtr> m_configKeyIndex;
+
+    std::pmr::deque<Subcommand> m_subcommands;
+
+    std::pmr::unordered_map<std::string_view, const Subcommand *> m_subcommandIndex;
+
+    MultiStringCallback m_positionalArgumentCallback = nullptr;
+
+    MultiStringViewCallback m_positionalArgumentViewCallback = nullptr;
+
+    size_t m_positionalArgumentBatchSize = 0;
+
+    bool m_responseFileExpansion = false;
+
+    size_t m_multiValueOptionCount = 0;
+
+    bool m_finalized = false;
+
+    //! Section of the options being added.
+    std::pmr::string m_helpSection;
+
+    static constexpr size_t HelpMargin = 2;
+
+    static constexpr std::string_view HelpOptionsTitle = "Options:\n\n";
+
+    static constexpr std::string_view HelpCommandsTitle = "Commands:\n\n";
+
+    std::pmr::string m_renderedHelp;
+
+    //! Lines of the options in the order of the help.
+    std::pmr::vector<HelpLine> m_helpLines;
+
+    //! Width of the argument column including the margin.
+    size_t m_helpColumn = 0;
+
+    //! Length of the help text and the empty line after it in the rendered help.
+    size_t m_helpHeaderLength = 0;
+
+    //! Offset of the empty line after the options in the rendered help.
+    size_t m_helpOptionsEnd = 0;
+
+    bool m_helpRendered = false;
+};
+
+//! Options grouped by slot, i.e. the rank of the option among the given options in the presence bitmask, so that
+//! the values of an option are contiguous.
+class Argengine::ParseResult::Impl : public ResourceAllocated
+{
+public:
+    explicit Impl(std::shared_ptr<const Schema> schema, std::pmr::memory_resource * resource)
+      : resource(resource)
+      , schema(schema)
+      , presence(&this->resource)
+      , rank(&this->resource)
+      , counts(&this->resource)
+      , valueOffsets(&this->resource)
+      , values(&this->resource)
+      , positionalArguments(&this->resource)
+      , subcommandArguments(&this->resource)
+      , files(&this->resource)
+    {
+    }
+
+    static constexpr size_t NoSlot = std::numeric_limits<size_t>::max();
+
+    //! \return The slot of the given option or NoSlot if the option was not given.
+    size_t slot(std::string_view option) const
+    {
+        if (const auto definition = schema->getOptionDefinition(option)) {
+            if (const auto word = definition->id / BitsPerWord; word < presence.size() && testBit(presence.data(), definition->id)) {
+                const auto lowerBits = presence.at(word) & ((uint64_t { 1 } << (definition->id % BitsPerWord)) - 1);
+                return rank.at(word) + countBits(lowerBits);
+            }
+        }
+        return NoSlot;
+    }
+
+    //! Counts the allocations of the result for the stats of the parse.
+    CountingResource resource;
+
+    std::shared_ptr<const Schema> schema;
+
+    //! Bitmask of the given definitions.
+    Bitmask presence;
+
+    //! Number of given definitions before each word of the presence bitmask.
+    std::pmr::vector<size_t> rank;
+
+    //! Number of occurrences by slot.
+    std::pmr::vector<size_t> counts;
+
+    //! Offsets of the values of each slot. Has a terminating offset.
+    std::pmr::vector<size_t> valueOffsets;
+
+    ArgumentViewVector values;
+
+    ArgumentViewVector positionalArguments;
+
+    ArgumentViewVector subcommandArguments;
+
+    //! Keeps the response files and the config file mapped as the values are views to them.
+    std::pmr::vector<MappedFileSP> files;
+};
+
+//! A parsing instance. Holds the arguments and the state of a parse, the configuration is in the (possibly shared) schema.
+class Argengine::Impl : public ResourceAllocated
+{
+public:
+    //! Copies the arguments.
+    template<typename Iterator>
+    Impl(Iterator begin, Iterator end, bool addDefaultHelp, std::pmr::memory_resource * resource)
+      : m_resource(resourceOrDefault(resource))
+      , m_args(begin, end, m_resource)
+      , m_argumentViews(m_args.begin(), m_args.end(), m_resource)
+      , m_schema(Schema::create(m_resource))
+    {
+        init(addDefaultHelp);
+    }
+
+    //! Zero-copy constructor: the arguments are only referenced.
+    Impl(int argc, char ** argv, bool addDefaultHelp, std::pmr::memory_resource * resource)
+      : m_resource(resourceOrDefault(resource))
+      , m_argumentViews(argv, argv + argc, m_resource)
+      , m_schema(Schema::create(m_resource))
+    {
+        init(addDefaultHelp);
+    }
+
+    Impl(SchemaSP schema, const ArgumentVector & args, std::pmr::memory_resource * resource)
+      : m_resource(resourceOrDefault(resource))
+      , m_args(args.begin(), args.end(), m_resource)
+      , m_argumentViews(m_args.begin(), m_args.end(), m_resource)
+      , m_schema(std::const_pointer_cast<Schema>(schema))
+      , m_schemaShared(true)
+    {
+        init(false);
+    }
+
+    //! Zero-copy constructor for a split command line.
+    Impl(StringViewSpan args, bool addDefaultHelp, std::pmr::memory_resource * resource)
+      : m_resource(resourceOrDefault(resource))
+      , m_argumentViews(args.begin(), args.end(), m_resource)
+      , m_schema(Schema::create(m_resource))
+    {
+        init(addDefaultHelp);
+    }
+
+    Impl(SchemaSP schema, StringViewSpan args, std::pmr::memory_resource * resource)
+      : m_resource(resourceOrDefault(resource))
+      , m_argumentViews(args.begin(), args.end(), m_resource)
+      , m_schema(std::const_pointer_cast<Schema>(schema))
+      , m_schemaShared(true)
+    {
+        init(false);
+    }
+
+    //! Instance for parsing batches of arguments given to parse(args, dispatch).
+    Impl(SchemaSP schema, std::pmr::memory_resource * resource)
+      : m_resource(resourceOrDefault(resource))
+      , m_argumentViews(m_resource)
+      , m_schema(std::const_pointer_cast<Schema>(schema))
+      , m_schemaShared(true)
+      , m_batch(true)
+    {
+    }
+
+    //! \return The schema for modifications. A compiled schema is never modified, but copied on the first write.
+    Schema & schema()
+    {
+        if (m_schemaShared) {
+            m_schema = Schema::create(m_resource, *m_schema);
+            m_schemaShared = false;
+        }
+        return *m_schema;
+    }
+
+    const Schema & schema() const
+    {
+        return *m_schema;
+    }
+
+    SchemaSP compile()
+    {
+        if (!m_schema->isFinalized()) {
+            m_schema->finalize();
+        }
+        if (!m_schema->isHelpRendered()) {
+            m_schema->renderHelp();
+        }
+        m_schemaShared = true;
+        return m_schema;
+    }
+
+    ArgumentVector arguments() const
+    {
+        return { m_argumentViews.begin(), m_argumentViews.end() };
+    }
+
+    void setOutputStream(std::ostream & out)
+    {
+        m_out = &out;
+    }
+
+    void printHelp() const
+    {
+        // A shared schema is always rendered by compile()
+        if (!m_schema->isHelpRendered()) {
+            m_schema->renderHelp();
+        }
+        m_schema->printHelp(*m_out);
+    }
+
+    void printHelp(std::string_view filter) const
+    {
+        if (filter.empty()) {
+            printHelp();
+        } else {
+            if (!m_schema->isHelpRendered()) {
+                m_schema->renderHelp();
+            }
+            m_schema->printHelp(*m_out, filter);
+        }
+    }
+
+    bool parse()
+    {
+        return parse(m_argumentViews, true);
+    }
+
+    //! Parses the given arguments instead of the ones given to the constructor.
+    template<typename Iterator>
+    bool parse(Iterator begin, Iterator end)
+    {
+        return assignArguments(begin, end) && parse(m_givenArgumentViews, true);
+    }
+
+    //! \param args Arguments including the program name.
+    //! \param dispatch If false, the arguments are only checked and no callbacks are called.
+    //! \param result If set, the options and positional arguments are stored to it. No callbacks are called.
+    //! \return False on error. The error is available from error() until the next parse.
+    bool parse(const ArgumentViewVector & args, bool dispatch, ParseResult::Impl * result = nullptr)
+    {
+        // The state refers to the arena
+        m_parseState.reset();
+        m_stats = {};
+        m_helpFilter = {};
+        m_responseFiles.clear();
+        m_configFile.reset();
+        // The result has been counted by createResult()
+        if (!result) {
+            m_parseObjects.resetCounters();
+        }
+        resetArena();
+        resetFailure();
+
+        ArgumentViewVector subcommandArguments { &m_parseResource };
+        ArgumentViewVector tokens { &m_parseResource };
+        if (!measure(m_stats.tokenizeTime, [&] {
+                if (m_schema->responseFileExpansion()) {
+                    ArgumentViewVector expanded { &m_parseResource };
+                    if (!expandResponseFiles(args, expanded)) {
+                        return false;
+                    }
+                    tokens = tokenize(expanded, subcommandArguments);
+                } else {
+                    tokens = tokenize(args, subcommandArguments);
+                }
+                return true;
+            })) {
+            return false;
+        }
+
+        // A shared schema is always finalized by compile()
+        if (!m_schema->isFinalized()) {
+            m_schema->finalize();
+        }
+
+        Bitmask seen(m_schema->bitmaskWords(), 0, &m_parseResource);
+        ResolvedTokenVector resolvedTokens { &m_parseResource };
+        if (!measure(m_stats.resolveTime, [&] {
+                return resolveTokens(tokens, resolvedTokens, seen);
+            })) {
+            return false;
+        }
+
+        if (m_schema->hasEnvironmentVariables()) {
+            if (!measure(m_stats.resolveTime, [&] {
+                    return resolveEnvironmentVariables(tokens, resolvedTokens, seen);
+                })) {
+                return false;
+            }
+        }
+
+        if (!m_configFilePath.empty()) {
+            if (!measure(m_stats.resolveTime, [&] {
+                    return resolveConfigFile(tokens, resolvedTokens, seen);
+                })) {
+                return false;
+            }
+        }
+
+        const auto multiValues = measure(m_stats.resolveTime, [&] {
+            return gatherMultiValues(tokens, resolvedTokens);
+        });
+
+        if (!measure(m_stats.conflictCheckTime, [&] {
+                return m_schema->checkConflictingOptions(seen, &m_parseResource, m_failure);
+            })) {
+            return false;
+        }
+
+        if (!measure(m_stats.groupCheckTime, [&] {
+                return m_schema->checkOptionGroups(seen, &m_parseResource, m_failure);
+            })) {
+            return false;
+        }
+
+        // Help is not processed in batches as it exits
+        if (dispatch && !m_batch) {
+            measure(m_stats.dispatchTime, [&] {
+                processHelp(resolvedTokens);
+            });
+        }
+
+        if (!checkResolvedTokens(resolvedTokens)) {
+            return false;
+        }
+
+        if (!measure(m_stats.requiredCheckTime, [&] {
+                return m_schema->checkRequired(seen, m_failure);
+            })) {
+            return false;
+        }
+
+        if (result) {
+            measure(m_stats.dispatchTime, [&] {
+                buildResult(tokens, resolvedTokens, seen, subcommandArguments, *result);
+            });
+            m_parseObjects.count(result->resource);
+            return true;
+        }
+
+        // The arguments of the subcommand are checked before any callbacks of this instance are called
+        SubcommandUP subcommand;
+        if (!subcommandArguments.empty()) {
+            subcommand = createSubcommand(args.at(0), subcommandArguments);
+            if (!checkSubcommand(*subcommand)) {
+                return false;
+            }
+        }
+
+        m_parseState.emplace(ParseState { std::move(resolvedTokens), std::move(multiValues), std::move(subcommand) });
+        if (dispatch) {
+            this->dispatch(false);
+        }
+
+        return true;
+    }
+
+    //! Calls the callbacks of the latest parse and then those of its subcommand, if any. The arguments have been
+    //! resolved and checked by the parse, so this can't fail.
+    //! \param help If true, the help is processed first. The help of a parse with dispatching is processed before the checks.
+    void dispatch(bool help)
+    {
+        const auto & state = *m_parseState;
+        measure(m_stats.dispatchTime, [&] {
+            if (help && !m_batch) {
+                processHelp(state.resolvedTokens);
+            }
+            processResolvedTokens(state.resolvedTokens, state.multiValues);
+        });
+        if (state.subcommand) {
+            state.subcommand->m_impl->dispatch(true);
+        }
+    }
+
+    //! \return The error of the latest parse. The message is formatted here.
+    Error error() const
+    {
+        return { m_failure.code, errorMessage() };
+    }
+
+    Error::Code errorCode() const
+    {
+        return m_failure.code;
+    }
+
+    std::string errorMessage() const
+    {
+        return m_schema->failureMessage(m_failure, m_configFilePath);
+    }
+
+    //! Throws the error of the latest parse, if any.
+    void throwIfFailed() const
+    {
+        if (m_failure.code != Error::Code::Ok) {
+            throwError(errorMessage());
+        }
+    }
+
+    //! Runs the parse and sets the error from its failure or from the exception thrown by a callback, if any.
+    template<typename Function>
+    void catchError(Function && function, Error & error) const
+    {
+#ifdef ARGENGINE_EXCEPTIONS
+        try {
+            function();
+        } catch (std::runtime_error & e) {
+            error = { Error::Code::Failed, e.what() };
+            return;
+        }
+#else
+        function();
+#endif
+        error = this->error();
+    }
+
+    //! \return An empty result referring to the current schema.
+    std::unique_ptr<ParseResult::Impl> createResult()
+    {
+        // The result refers to the schema, so it's never modified afterwards, but copied on the next write
+        m_schemaShared = true;
+        // Counted for the parse that follows
+        m_parseObjects.resetCounters();
+        return std::unique_ptr<ParseResult::Impl>(new (m_resource, m_parseObjects) ParseResult::Impl(m_schema, m_resource));
+    }
+
+    bool parseResult(ParseResult::Impl & result)
+    {
+        return parse(m_argumentViews, false, &result);
+    }
+
+    bool parseResult(StringViewSpan args, ParseResult::Impl & result)
+    {
+        return assignArguments(args.begin(), args.end()) && parse(m_givenArgumentViews, false, &result);
+    }
+
+    //! Number of lines a thread of parseBatch() takes at a time.
+    static constexpr size_t BatchChunkSize = 256;
+
+    static std::vector<Error> parseBatch(const SchemaSP & schema, const std::string & path, bool dispatch, size_t threadCount)
+    {
+        MappedFile file { path.c_str(), std::pmr::get_default_resource() };
+        if (!file.isValid()) {
+            throwError(Schema::name() + ": Batch file '" + path + "' cannot be read!");
+        }
+
+        std::vector<std::pair<char *, char *>> lines;
+        for (char * begin = file.begin(); begin != file.end();) {
+            const auto end = std::find(begin, file.end(), '\n');
+            lines.emplace_back(begin, end);
+            begin = end == file.end() ? end : end + 1;
+        }
+
+        std::vector<Error> errors(lines.size());
+        std::atomic<size_t> nextChunk {};
+        const auto worker = [&] {
+            Impl impl { schema, nullptr };
+            ArgumentViewVector args;
+            for (size_t chunk = nextChunk++; chunk * BatchChunkSize < lines.size(); chunk = nextChunk++) {
+                for (size_t i = chunk * BatchChunkSize; i < std::min(lines.size(), (chunk + 1) * BatchChunkSize); i++) {
+                    args.clear();
+                    if (!splitInPlace(lines.at(i).first, lines.at(i).second, args)) {
+                        errors.at(i) = { Error::Code::Failed, Schema::name() + ": Line " + std::to_string(i + 1) + " has an unterminated quote!" };
+                    } else if (!args.empty()) {
+                        impl.catchError(
+                          [&] {
+                              impl.parse(args, dispatch);
+                          },
+                          errors.at(i));
+                    }
+                }
+            }
+        };
+
+        if (!threadCount) {
+            threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        threadCount = std::min(threadCount, (lines.size() + BatchChunkSize - 1) / BatchChunkSize);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto && thread : threads) {
+            thread.join();
+        }
+
+        return errors;
+    }
+
+    Stats stats() const
+    {
+        auto stats = m_stats;
+        stats.allocations = m_parseUpstream.allocations() + m_parseObjects.allocations();
+        stats.allocatedBytes = m_parseUpstream.allocatedBytes() + m_parseObjects.allocatedBytes();
+        stats.bufferBytes = m_parseResource.allocatedBytes();
+        return stats;
+    }
+
+    void setConfigFile(const std::string & path, bool required)
+    {
+        m_configFilePath = path;
+        m_configFileRequired = required;
+    }
+
+    void setAutoDash(bool autoDash)
+    {
+        m_autoDash = autoDash;
+    }
+
+    ~Impl() = default;
+
+private:
+    using OptionDefinitionPtr = Schema::OptionDefinitionPtr;
+
+    //! A token matched to its definition. A token without a definition is a positional argument.
+    struct ResolvedToken
+    {
+        enum class Status
+        {
+            Ok,
+            MissingValue,
+            TooFewValues,
+            Unknown
+        };
+
+        OptionDefinitionPtr definition = nullptr;
+
+        size_t index = 0;
+
+        std::string_view value;
+
+        Schema::TypedValue typedValue;
+
+        //! Number of values of a multi-value option. The values are the tokens following the option.
+        size_t valueCount = 0;
+
+        Status status = Status::Ok;
+    };
+
+    using ResolvedTokenVector = std::pmr::vector<ResolvedToken>;
+
+    void init(bool addDefaultHelp)
+    {
+        if (m_argumentViews.empty()) {
+            throwError(Schema::name() + ": Argument vector is empty!");
+        }
+
+        if (addDefaultHelp) {
+            m_schema->addHelp(m_argumentViews.at(0));
+        }
+    }
+
+    //! Maximum nesting of response files, i.e. response files referring to response files.
+    static constexpr size_t MaxResponseFileDepth = 16;
+
+    //! Replaces arguments of the form "@path" with the arguments in the given file. The file is mapped to memory and
+    //! the arguments are views to it, so it stays mapped until the next parse.
+    //! \param expanded The arguments are appended to it.
+    //! \return False if a file can't be expanded.
+    bool expandResponseFiles(const ArgumentViewVector & args, ArgumentViewVector & expanded, size_t depth = 0)
+    {
+        expanded.reserve(expanded.size() + args.size());
+        for (size_t i = 0; i < args.size(); i++) {
+            if (const auto arg = args.at(i); i + depth > 0 && arg.size() > 1 && arg.front() == '@') {
+                const auto path = arg.substr(1);
+                if (depth == MaxResponseFileDepth) {
+                    return Schema::fail(m_failure, Schema::Failure::Reason::ResponseFileTooDeep, nullptr, path);
+                }
+                const std::pmr::string pathString { path, &m_parseResource };
+                auto responseFile = createMappedFile(pathString.c_str());
+                if (!responseFile->isValid()) {
+                    return Schema::fail(m_failure, Schema::Failure::Reason::ResponseFileUnreadable, nullptr, path);
+                }
+                ArgumentViewVector fileArgs { &m_parseResource };
+                if (!splitInPlace(responseFile->begin(), responseFile->end(), fileArgs)) {
+                    return Schema::fail(m_failure, Schema::Failure::Reason::ResponseFileUnterminatedQuote, nullptr, path);
+                }
+                m_responseFiles.push_back(std::move(responseFile));
+                if (!expandResponseFiles(fileArgs, expanded, depth + 1)) {
+                    return false;
+                }
+            } else {
+                expanded.push_back(arg);
+            }
+        }
+        return true;
+    }
+
+    //! \return The tokens of the arguments before the subcommand, if any.
+    //! \param subcommandArguments Set to the subcommand and the arguments after it.
+    ArgumentViewVector tokenize(const ArgumentViewVector & args, ArgumentViewVector & subcommandArguments)
+    {
+        if (m_schema->hasSubcommands()) {
+            if (const auto index = m_schema->findSubcommand(args, m_stats.lookups)) {
+                const auto subcommand = args.begin() + static_cast<std::ptrdiff_t>(index);
+                subcommandArguments.assign(subcommand, args.end());
+                return m_schema->tokenize({ args.begin(), subcommand, &m_parseResource }, &m_parseResource, m_stats.lookups, m_helpFilter);
+            }
         }
+        return m_schema->tokenize(args, &m_parseResource, m_stats.lookups, m_helpFilter);
     }
 
-    void addHelp()
+    //! \return A file mapped until the next parse, or as long as a result refers to it.
+    MappedFileSP createMappedFile(const char * path)
     {
-        m_helpText = "Usage: " + m_args.at(0) + " [OPTIONS]";
+        return std::allocate_shared<MappedFile>(CountedAllocator<MappedFile> { m_resource, m_parseObjects }, path, m_resource);
+    }
 
-        const auto helpDefinition = addOption(
-          { "-h", "--help" }, [=] {
-              printHelp();
-              exit(EXIT_SUCCESS);
-          },
-          false, SHOW_THIS_HELP_TEXT);
+    //! Instance of a subcommand. It's in the arena with its schema and arguments, so it must be gone before the next parse.
+    using SubcommandUP = std::unique_ptr<Argengine, ArenaDelete>;
 
-        helpDefinition->isHelp = true;
+    //! \return A new instance for the arguments of the subcommand, configured by its factory.
+    SubcommandUP createSubcommand(std::string_view applicationName, const ArgumentViewVector & subcommandArguments)
+    {
+        const auto subcommand = m_schema->getSubcommand(subcommandArguments.front());
+        std::pmr::string name { applicationName, &m_parseResource };
+        name += ' ';
+        name += subcommand->name;
+        ArgumentViewVector args { &m_parseResource };
+        args.reserve(subcommandArguments.size());
+        args.push_back(name);
+        args.insert(args.end(), subcommandArguments.begin() + 1, subcommandArguments.end());
+        std::unique_ptr<Impl> impl { new (&m_parseResource) Impl(args.begin(), args.end(), true, &m_parseResource) };
+        SubcommandUP argengine { new (m_parseResource.allocate(sizeof(Argengine), alignof(Argengine))) Argengine(std::move(impl)) };
+        argengine->setOutputStream(*m_out);
+        argengine->m_impl->m_batch = m_batch;
+        subcommand->factory(*argengine);
+        return argengine;
     }
 
-    void checkRequired()
+    //! Checks the arguments of the subcommand with its instance. The instance keeps them resolved for dispatch().
+    //! \return False on error. The message is formatted here as the instance is gone afterwards.
+    bool checkSubcommand(Argengine & argengine)
     {
-        for (auto && definition : m_optionDefinitions) {
-            if (definition->required && !definition->applied) {
-                throwRequiredError(*definition);
-            }
+        if (!argengine.m_impl->parse(argengine.m_impl->m_argumentViews, false)) {
+            m_failure.reason = Schema::Failure::Reason::Subcommand;
+            m_failure.code = argengine.m_impl->errorCode();
+            m_failure.message = argengine.m_impl->errorMessage();
+            return false;
         }
+        return true;
     }
 
-    OptionDefinitionSP getOptionDefinition(const OptionSet & variants) const
+    OptionDefinitionPtr getOptionDefinition(std::string_view argument)
     {
-        const auto item = std::find_if(m_optionDefinitions.begin(), m_optionDefinitions.end(), [=](const auto & definition) {
-            return definition->matches(variants);
-        });
-        return item != m_optionDefinitions.end() ? *item : nullptr;
+        m_stats.lookups++;
+        return m_schema->getOptionDefinition(argument);
+    }
+
+    //! Frees the buffers of the previous parse. If the previous parse took more memory than the initial buffer of the
+    //! arena, the buffer grows by that amount, so that repeated parses of similar arguments don't allocate at all.
+    void resetArena()
+    {
+        const auto overflow = m_parseUpstream.allocatedBytes() - m_parseBufferGrowth;
+        m_parseUpstream.resetCounters();
+        m_parseResource.resetCounters();
+        m_parseBufferGrowth = 0;
+        if (overflow) {
+            m_parseArena.reset();
+            const auto size = m_parseBuffer.size() + overflow;
+            m_parseBuffer.clear();
+            m_parseBuffer.shrink_to_fit();
+            m_parseBuffer.resize(size);
+            m_parseBufferGrowth = m_parseUpstream.allocatedBytes();
+            // The address of the arena doesn't change, so m_parseResource still refers to it
+            m_parseArena.emplace(m_parseBuffer.data(), m_parseBuffer.size(), &m_parseUpstream);
+        } else {
+            m_parseArena->release();
+        }
     }
 
-    OptionDefinitionSP getOptionDefinition(const std::string & argument) const
+    //! \return False if the arguments are empty.
+    template<typename Iterator>
+    bool assignArguments(Iterator begin, Iterator end)
     {
-        return getOptionDefinition(OptionSet { argument });
+        resetFailure();
+        // The buffer keeps its capacity, so repeated parses don't allocate for it
+        m_givenArgumentViews.assign(begin, end);
+        return !m_givenArgumentViews.empty() || Schema::fail(m_failure, Schema::Failure::Reason::EmptyArguments);
     }
 
-    OptionDefinitionSP getOptionDefinition(const std::string & argument, const OptionDefinitionVector & optionDefinitions) const
+    void resetFailure()
     {
-        const auto item = std::find_if(optionDefinitions.begin(), optionDefinitions.end(), [=](const auto & definition) {
-            return definition->matches({ argument });
-        });
-        return item != optionDefinitions.end() ? *item : nullptr;
+        m_failure.reason = Schema::Failure::Reason::None;
+        m_failure.code = Error::Code::Ok;
     }
 
-    OptionDefinitionVector getOptionsDefinitionsForTokens(const ArgumentVector & tokens) const
+    //! Stores the options grouped by slot and the positional arguments to the result in two passes over the tokens.
+    void buildResult(const ArgumentViewVector & tokens, const ResolvedTokenVector & resolvedTokens, const Bitmask & seen, const ArgumentViewVector & subcommandArguments, ParseResult::Impl & result) const
     {
-        OptionDefinitionVector optionDefinitions;
-        for (size_t i = 1; i < tokens.size(); i++) {
-            const auto arg = tokens.at(i);
-            if (const auto definition = getOptionDefinition(arg); definition) {
-                optionDefinitions.push_back(definition);
+        result.presence.assign(seen.begin(), seen.end());
+        result.rank.resize(seen.size());
+        size_t slots = 0;
+        for (size_t i = 0; i < seen.size(); i++) {
+            result.rank.at(i) = slots;
+            slots += countBits(seen.at(i));
+        }
+
+        const auto slotOf = [&result](size_t id) {
+            const auto lowerBits = result.presence.at(id / BitsPerWord) & ((uint64_t { 1 } << (id % BitsPerWord)) - 1);
+            return result.rank.at(id / BitsPerWord) + countBits(lowerBits);
+        };
+        const auto valueCount = [](const ResolvedToken & resolvedToken) -> size_t {
+            return resolvedToken.definition->isMultiValue() ? resolvedToken.valueCount : resolvedToken.definition->hasValue();
+        };
+
+        result.counts.assign(slots, 0);
+        result.valueOffsets.assign(slots + 1, 0);
+        for (auto && resolvedToken : resolvedTokens) {
+            if (resolvedToken.definition) {
+                const auto slot = slotOf(resolvedToken.definition->id);
+                result.counts.at(slot)++;
+                result.valueOffsets.at(slot + 1) += valueCount(resolvedToken);
+            } else {
+                result.positionalArguments.push_back(resolvedToken.value);
             }
         }
-        return optionDefinitions;
+        for (size_t slot = 0; slot < slots; slot++) {
+            result.valueOffsets.at(slot + 1) += result.valueOffsets.at(slot);
+        }
+
+        result.values.resize(result.valueOffsets.back());
+        std::pmr::vector<size_t> filled { result.valueOffsets.begin(), result.valueOffsets.end() - 1, &m_parseResource };
+        for (auto && resolvedToken : resolvedTokens) {
+            if (resolvedToken.definition) {
+                auto & offset = filled.at(slotOf(resolvedToken.definition->id));
+                if (resolvedToken.definition->isMultiValue()) {
+                    const auto first = tokens.begin() + static_cast<std::ptrdiff_t>(resolvedToken.index + 1);
+                    std::copy(first, first + static_cast<std::ptrdiff_t>(resolvedToken.valueCount), result.values.begin() + static_cast<std::ptrdiff_t>(offset));
+                    offset += resolvedToken.valueCount;
+                } else if (resolvedToken.definition->hasValue()) {
+                    result.values.at(offset++) = resolvedToken.value;
+                }
+            }
+        }
+
+        result.subcommandArguments.assign(subcommandArguments.begin(), subcommandArguments.end());
+
+        result.files = m_responseFiles;
+        if (m_configFile) {
+            result.files.push_back(m_configFile);
+        }
     }
 
-    std::string name() const
+    bool isOptionOrEndOfOptions(std::string_view token)
     {
-        return "Argengine";
+        return token == EndOfOptions || getOptionDefinition(token);
     }
 
-    using ArgumentAndValue = std::pair<std::string, std::string>;
-
-    ArgumentAndValue splitAssignmentFormat(const std::string & arg) const
+    //! Matches tokens to definitions and values in a single pass. Errors are only recorded here so that
+    //! conflicts, groups and help can be processed before them.
+    //! \param seen Bitmask of the given definitions, filled in the same pass.
+    //! \return False on a value that can't be converted.
+    bool resolveTokens(const ArgumentViewVector & tokens, ResolvedTokenVector & resolvedTokens, Bitmask & seen)
     {
-        std::string assignmentFormatArg;
-        if (const auto pos = arg.find('='); pos != arg.npos) {
-            assignmentFormatArg = arg.substr(0, pos);
-            if (const auto match = getOptionDefinition(assignmentFormatArg); match && match->singleStringCallback) {
-                if (const auto valueLength = arg.size() - (pos + 1); !valueLength) {
-                    return { assignmentFormatArg, "" };
-                } else {
-                    return { assignmentFormatArg, arg.substr(pos + 1, valueLength) };
+        resolvedTokens.reserve(tokens.size());
+        m_stats.tokens = tokens.size() - 1;
+        bool endOfOptions = false;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            ResolvedToken resolvedToken;
+            resolvedToken.index = i;
+            if (const auto & token = tokens.at(i); !endOfOptions && token == EndOfOptions) {
+                endOfOptions = true;
+                continue;
+            } else if (!endOfOptions && (resolvedToken.definition = getOptionDefinition(token))) {
+                setBit(seen.data(), resolvedToken.definition->id);
+                if (resolvedToken.definition->isMultiValue()) {
+                    const auto & arity = resolvedToken.definition->arity;
+                    while (resolvedToken.valueCount < arity.max && i + 1 < tokens.size() && !isOptionOrEndOfOptions(tokens.at(i + 1))) {
+                        resolvedToken.valueCount++;
+                        i++;
+                    }
+                    if (resolvedToken.valueCount < arity.min) {
+                        resolvedToken.status = ResolvedToken::Status::TooFewValues;
+                    }
+                } else if (resolvedToken.definition->hasValue()) {
+                    if (i + 1 < tokens.size() && !isOptionOrEndOfOptions(tokens.at(i + 1))) {
+                        resolvedToken.value = tokens.at(++i);
+                        if (!m_schema->convertValue(*resolvedToken.definition, resolvedToken.value, resolvedToken.typedValue, m_failure)) {
+                            return false;
+                        }
+                    } else {
+                        resolvedToken.status = ResolvedToken::Status::MissingValue;
+                    }
+                }
+            } else {
+                resolvedToken.value = token;
+                if (!m_schema->hasPositionalArgumentCallback()) {
+                    resolvedToken.status = ResolvedToken::Status::Unknown;
                 }
             }
+            resolvedTokens.push_back(resolvedToken);
         }
-        return {};
+        return true;
     }
 
-    ArgumentAndValue splitSpacelessFormat(const std::string & arg) const
+    //! Takes the options bound to environment variables, that were not given in the arguments, from the environment
+    //! in a single scan. The option and the value are appended to the tokens as if they were given last.
+    bool resolveEnvironmentVariables(ArgumentViewVector & tokens, ResolvedTokenVector & resolvedTokens, Bitmask & seen)
     {
-        std::map<OptionDefinitionSP, std::string> matchingDefinitions;
-        for (auto && definition : m_optionDefinitions) {
-            for (auto && variant : definition->variants) {
-                if (arg.find(variant) == 0) {
-                    matchingDefinitions[definition] = variant;
-                }
+        for (auto variable = environ; variable && *variable; variable++) {
+            const std::string_view entry { *variable };
+            const auto pos = entry.find('=');
+            if (pos == entry.npos) {
+                continue;
             }
-        }
-        if (matchingDefinitions.size() == 1) {
-            if (const auto match = matchingDefinitions.begin()->first; match && match->singleStringCallback) {
-                const auto spacelessArg = matchingDefinitions.begin()->second;
-                const auto pos = spacelessArg.size();
-                if (const auto valueLength = arg.size() - pos; !valueLength) {
-                    return { spacelessArg, "" };
-                } else {
-                    return { spacelessArg, arg.substr(pos, valueLength) };
-                }
+            m_stats.lookups++;
+            const auto definition = m_schema->getOptionDefinitionForEnvironmentVariable(entry.substr(0, pos));
+            if (!definition || testBit(seen.data(), definition->id)) {
+                continue;
+            }
+            if (!appendResolvedToken(definition, entry.substr(pos + 1), tokens, resolvedTokens, seen)) {
+                return false;
             }
         }
-        return {};
+        return true;
     }
 
-    ArgumentVector tokenize(const ArgumentVector & args) const
+    //! Takes the options from the config file, that were not given in the arguments or environment variables.
+    bool resolveConfigFile(ArgumentViewVector & tokens, ResolvedTokenVector & resolvedTokens, Bitmask & seen)
     {
-        ArgumentVector tokens;
+        m_configFile = createMappedFile(m_configFilePath.c_str());
+        if (!m_configFile->isValid()) {
+            m_configFile.reset();
+            return !m_configFileRequired || Schema::fail(m_failure, Schema::Failure::Reason::ConfigFileUnreadable);
+        }
 
-        for (auto && arg : args) {
-            if (const auto assignmentTokens = splitAssignmentFormat(arg); !assignmentTokens.first.empty()) {
-                tokens.push_back(assignmentTokens.first);
-                if (!assignmentTokens.second.empty()) {
-                    tokens.push_back(assignmentTokens.second);
-                }
-            } else {
-                if (const auto spacelessTokens = splitSpacelessFormat(arg); !spacelessTokens.first.empty()) {
-                    tokens.push_back(spacelessTokens.first);
-                    if (!spacelessTokens.second.empty()) {
-                        tokens.push_back(spacelessTokens.second);
-                    }
-                } else {
-                    tokens.push_back(arg);
+        const Bitmask seenBefore { seen, &m_parseResource };
+        if (const auto malformedLine = forEachConfigEntry({ m_configFile->begin(), static_cast<size_t>(m_configFile->end() - m_configFile->begin()) }, [&](std::string_view key, std::string_view value, size_t line) {
+                m_stats.lookups++;
+                const auto definition = m_schema->getOptionDefinitionForConfigKey(key);
+                if (!definition) {
+                    return Schema::fail(m_failure, Schema::Failure::Reason::ConfigFileUnknownOption, nullptr, key, line);
                 }
-            }
+                return testBit(seenBefore.data(), definition->id) || appendResolvedToken(definition, value, tokens, resolvedTokens, seen);
+            })) {
+            return Schema::fail(m_failure, Schema::Failure::Reason::ConfigFileMalformed, nullptr, {}, malformedLine);
         }
-
-        return tokens;
+        return m_failure.reason == Schema::Failure::Reason::None;
     }
 
-    void checkConflictingOptions(const ArgumentVector & tokens)
+    //! Appends an option taken from outside the arguments to the tokens as if it was given last.
+    //! A valueless option is applied for "1", "true", "yes" and "on" and ignored for "", "0", "false", "no" and "off".
+    //! The value of a multi-value option is split at whitespace and checked against the arity.
+    //! \return False on a value that can't be converted or on too many values.
+    bool appendResolvedToken(OptionDefinitionPtr definition, std::string_view value, ArgumentViewVector & tokens, ResolvedTokenVector & resolvedTokens, Bitmask & seen)
     {
-        const auto optionDefinitions = getOptionsDefinitionsForTokens(tokens);
-        for (auto && conflictingOptionSet : m_conflictingOptionSets) {
-            OptionSet conflictingOptionSetForError;
-            for (auto && conflictingOption : conflictingOptionSet) {
-                for (auto && optionDefinition : optionDefinitions) {
-                    if (optionDefinition->matches({ conflictingOption })) {
-                        conflictingOptionSetForError.insert(conflictingOption);
-                    }
-                }
+        if (!definition->hasValue()) {
+            if (value.empty() || value == "0" || value == "false" || value == "no" || value == "off") {
+                return true;
+            }
+            if (value != "1" && value != "true" && value != "yes" && value != "on") {
+                return Schema::fail(m_failure, Schema::Failure::Reason::InvalidValue, definition, value);
+            }
+        }
+        ResolvedToken resolvedToken;
+        resolvedToken.definition = definition;
+        resolvedToken.index = tokens.size();
+        tokens.push_back(*definition->variants.begin());
+        if (definition->isMultiValue()) {
+            for (auto rest = trim(value); !rest.empty(); rest = trim(rest.substr(tokens.back().size()))) {
+                tokens.push_back(rest.substr(0, rest.find_first_of(" \t\r")));
+                resolvedToken.valueCount++;
+            }
+            const auto & arity = definition->arity;
+            if (resolvedToken.valueCount > arity.max) {
+                return Schema::fail(m_failure, Schema::Failure::Reason::InvalidValue, definition, value);
             }
-            if (conflictingOptionSetForError.size() > 1) {
-                throwConflictingOptionsError(conflictingOptionSetForError);
+            if (resolvedToken.valueCount < arity.min) {
+                resolvedToken.status = ResolvedToken::Status::TooFewValues;
+            }
+        } else if (definition->hasValue()) {
+            tokens.push_back(value);
+            resolvedToken.value = value;
+            if (!m_schema->convertValue(*definition, value, resolvedToken.typedValue, m_failure)) {
+                return false;
             }
         }
+        setBit(seen.data(), definition->id);
+        resolvedTokens.push_back(resolvedToken);
+        return true;
     }
 
-    void checkOptionGroups(const ArgumentVector & tokens)
+    //! \return False on the first token with an error.
+    bool checkResolvedTokens(const ResolvedTokenVector & resolvedTokens)
     {
-        const auto optionDefinitions = getOptionsDefinitionsForTokens(tokens);
-        for (auto && optionGroupSet : m_optionGroupSets) {
-            size_t optionsFound = 0;
-            OptionSet missingOptions;
-            for (auto && optionGroupOption : optionGroupSet) {
-                if (const auto optionDefinition = getOptionDefinition(optionGroupOption, optionDefinitions); optionDefinition) {
-                    optionsFound++;
-                } else {
-                    missingOptions.insert(optionGroupOption);
-                }
+        for (auto && resolvedToken : resolvedTokens) {
+            switch (resolvedToken.status) {
+            case ResolvedToken::Status::MissingValue:
+                return Schema::fail(m_failure, Schema::Failure::Reason::NoValue, resolvedToken.definition);
+            case ResolvedToken::Status::TooFewValues:
+                return Schema::fail(m_failure, Schema::Failure::Reason::TooFewValues, resolvedToken.definition);
+            case ResolvedToken::Status::Unknown:
+                return Schema::fail(m_failure, Schema::Failure::Reason::UnknownOption, nullptr, resolvedToken.value);
+            case ResolvedToken::Status::Ok:
+                break;
             }
-            if (optionsFound && optionsFound < optionGroupSet.size()) {
-                throwOptionGroupError(optionGroupSet, missingOptions);
+        }
+        return true;
+    }
+
+    // Process help first as it's a special case
+    void processHelp(const ResolvedTokenVector & resolvedTokens) const
+    {
+        for (auto && resolvedToken : resolvedTokens) {
+            if (resolvedToken.definition && resolvedToken.definition->isHelp) {
+                processResolvedToken(resolvedToken);
+                break;
             }
         }
     }
 
-    void processArgs(bool dryRun)
+    //! Values of the multi-value options gathered into a single buffer.
+    struct MultiValues
     {
-        const auto tokens = tokenize(m_args);
+        //! Values of each option are contiguous.
+        ArgumentViewVector values;
 
-        checkConflictingOptions(tokens);
+        struct Range
+        {
+            size_t offset = 0;
 
-        checkOptionGroups(tokens);
+            size_t count = 0;
 
-        // Process help first as it's a special case
-        for (size_t i = 1; i < tokens.size(); i++) {
-            if (const auto arg = tokens.at(i); const auto definition = getOptionDefinition(arg)) {
-                if (definition->isHelp) {
-                    processDefinitionMatch(definition, tokens, i, false);
-                    break;
-                }
-            }
+            //! Index of the first occurrence of the option, where the values are passed to the callback.
+            size_t firstIndex = 0;
+        };
+
+        //! Indexed by multi-value id, so that the size doesn't depend on the number of other options.
+        std::pmr::vector<Range> ranges;
+    };
+
+    //! Gathers the values of repeated multi-value options so that they can be passed at once.
+    MultiValues gatherMultiValues(const ArgumentViewVector & tokens, const ResolvedTokenVector & resolvedTokens) const
+    {
+        MultiValues multiValues { ArgumentViewVector { &m_parseResource }, std::pmr::vector<MultiValues::Range> { &m_parseResource } };
+        if (!m_schema->hasMultiValueOptions()) {
+            return multiValues;
         }
 
-        // Other arguments
-        ArgumentVector positionalArguments;
-        for (size_t i = 1; i < tokens.size(); i++) {
-            if (const auto arg = tokens.at(i); const auto definition = getOptionDefinition(arg)) {
-                if (!definition->isHelp) {
-                    i = processDefinitionMatch(definition, tokens, i, dryRun);
-                }
-            } else {
-                if (m_positionalArgumentCallback) {
-                    positionalArguments.push_back(arg);
-                } else {
-                    throwUnknownArgumentError(arg);
+        multiValues.ranges.resize(m_schema->multiValueOptionCount());
+        size_t total = 0;
+        for (auto && resolvedToken : resolvedTokens) {
+            if (resolvedToken.definition && resolvedToken.definition->isMultiValue()) {
+                auto & range = multiValues.ranges.at(resolvedToken.definition->multiValueId);
+                if (!range.firstIndex) {
+                    range.firstIndex = resolvedToken.index;
                 }
+                range.count += resolvedToken.valueCount;
+                total += resolvedToken.valueCount;
             }
         }
 
-        if (!positionalArguments.empty() && m_positionalArgumentCallback) {
-            m_positionalArgumentCallback(positionalArguments);
+        size_t offset = 0;
+        for (auto && range : multiValues.ranges) {
+            range.offset = offset;
+            offset += range.count;
+            range.count = 0;
+        }
+
+        multiValues.values.resize(total);
+        for (auto && resolvedToken : resolvedTokens) {
+            if (resolvedToken.definition && resolvedToken.definition->isMultiValue()) {
+                auto & range = multiValues.ranges.at(resolvedToken.definition->multiValueId);
+                const auto first = tokens.begin() + static_cast<std::ptrdiff_t>(resolvedToken.index + 1);
+                std::copy(first, first + static_cast<std::ptrdiff_t>(resolvedToken.valueCount), multiValues.values.begin() + static_cast<std::ptrdiff_t>(range.offset + range.count));
+                range.count += resolvedToken.valueCount;
+            }
         }
+
+        return multiValues;
     }
 
-    size_t processDefinitionMatch(OptionDefinitionSP match, const ArgumentVector & tokens, size_t currentIndex, bool dryRun) const
+    void processResolvedTokens(const ResolvedTokenVector & resolvedTokens, const MultiValues & multiValues) const
     {
-        if (match->valuelessCallback) {
-            if (!dryRun) {
-                match->valuelessCallback();
-            }
-            match->applied = true;
-        } else if (match->singleStringCallback) {
-            if (++currentIndex < tokens.size()) {
-                if (!dryRun) {
-                    if (const auto value = tokens.at(currentIndex); const auto innerMatch = getOptionDefinition(value)) {
-                        throwNoValueError(*match);
+        // With a batch size the positional arguments are streamed in order with the options using a fixed-size buffer
+        const auto batchSize = m_schema->positionalArgumentBatchSize();
+        ArgumentViewVector positionalArguments { &m_parseResource };
+        positionalArguments.reserve(batchSize);
+        for (auto && resolvedToken : resolvedTokens) {
+            if (resolvedToken.definition) {
+                if (resolvedToken.definition->isMultiValue()) {
+                    if (const auto & range = multiValues.ranges.at(resolvedToken.definition->multiValueId); range.firstIndex == resolvedToken.index) {
+                        resolvedToken.definition->multiValueCallback({ multiValues.values.data() + range.offset, range.count });
                     }
-                    match->singleStringCallback(tokens.at(currentIndex));
+                } else if (!resolvedToken.definition->isHelp) {
+                    processResolvedToken(resolvedToken);
                 }
-                match->applied = true;
             } else {
-                throwNoValueError(*match);
+                positionalArguments.push_back(resolvedToken.value);
+                if (positionalArguments.size() == batchSize) {
+                    m_schema->processPositionalArguments(positionalArguments);
+                    positionalArguments.clear();
+                }
             }
         }
-        return currentIndex;
-    }
 
-    std::string optionSetToString(const OptionSet & options) const
-    {
-        std::string optionsString;
-        for (auto && option : options) {
-            if (!optionsString.empty() && optionsString.back() == '\'') {
-                optionsString += ", ";
-            }
-            optionsString += "'" + option + "'";
+        if (!positionalArguments.empty()) {
+            m_schema->processPositionalArguments(positionalArguments);
         }
-        return optionsString;
     }
 
-    [[noreturn]] void throwConflictingOptionsError(const OptionSet & conflictingOptionSet) const
+    void processResolvedToken(const ResolvedToken & resolvedToken) const
     {
-        const auto optionsString = optionSetToString(conflictingOptionSet);
-        throw std::runtime_error(name() + ": Conflicting options: " + optionsString + ". These options cannot coexist.");
+        if (const auto & definition = *resolvedToken.definition; definition.valuelessCallback) {
+            definition.valuelessCallback();
+        } else if (definition.singleStringCallback) {
+            definition.singleStringCallback(std::string { resolvedToken.value });
+        } else if (definition.singleStringViewCallback) {
+            definition.singleStringViewCallback(resolvedToken.value);
+        } else if (definition.int64Callback) {
+            definition.int64Callback(std::get<int64_t>(resolvedToken.typedValue));
+        } else if (definition.doubleCallback) {
+            definition.doubleCallback(std::get<double>(resolvedToken.typedValue));
+        } else if (definition.boolCallback) {
+            definition.boolCallback(std::get<bool>(resolvedToken.typedValue));
+        } else if (definition.isHelp) {
+            printHelp(m_helpFilter);
+            exit(EXIT_SUCCESS);
+        }
     }
 
-    [[noreturn]] void throwOptionExistingError(const OptionDefinition & existing) const
-    {
-        throw std::runtime_error(name() + ": Option '" + existing.getVariantsString() + "' already defined!");
-    }
+    //! Upstream resource of the schema and the parse arena.
+    std::pmr::memory_resource * m_resource;
 
-    [[noreturn]] void throwOptionGroupError(const OptionSet & optionGroup, const OptionSet & missingOptions) const
-    {
-        const auto optionsString = optionSetToString(optionGroup);
-        const auto missingOptionsString = optionSetToString(missingOptions);
-        throw std::runtime_error(name() + ": These options must coexist: " + optionsString + ". Missing options: " + missingOptionsString + ".");
-    }
+    //! Owned copy of the arguments. Empty in the zero-copy mode.
+    std::pmr::vector<std::pmr::string> m_args;
 
-    [[noreturn]] void throwRequiredError(const OptionDefinition & existing) const
-    {
-        throw std::runtime_error(name() + ": Option '" + existing.getVariantsString() + "' is required!");
-    }
+    ArgumentViewVector m_argumentViews;
 
-    [[noreturn]] void throwUnknownArgumentError(const std::string & arg) const
-    {
-        throw std::runtime_error(name() + ": Unknown option '" + arg + "'!");
-    }
+    //! Arguments given to parse() instead of the constructor.
+    ArgumentViewVector m_givenArgumentViews { m_resource };
+
+    //! Counts the allocations of the parse that are not in the arena: the mapped files, the result and the failure.
+    CountingResource m_parseObjects { m_resource };
 
-    [[noreturn]] void throwNoValueError(const OptionDefinition & existing) const
+    std::pmr::vector<MappedFileSP> m_responseFiles { &m_parseObjects };
+
+    //! Counts the allocations of the parse buffers from the upstream resource.
+    CountingResource m_parseUpstream { m_resource };
+
+    //! Initial buffer of the arena, kept across parses.
+    std::pmr::vector<std::byte> m_parseBuffer { &m_parseUpstream };
+
+    //! Bytes allocated for m_parseBuffer by the latest parse. Not taken by the arena itself.
+    size_t m_parseBufferGrowth = 0;
+
+    //! Arena for the buffers of a parse. Everything in it is freed at once when the next parse starts.
+    std::optional<std::pmr::monotonic_buffer_resource> m_parseArena { std::in_place, &m_parseUpstream };
+
+    //! Counts the allocations from the arena. Mutable as the const helpers allocate from it.
+    mutable CountingResource m_parseResource { &*m_parseArena };
+
+    //! A parse that has been checked, kept for dispatch().
+    struct ParseState
     {
-        throw std::runtime_error(name() + ": No value for option '" + existing.getVariantsString() + "' given!");
-    }
+        ResolvedTokenVector resolvedTokens;
+
+        MultiValues multiValues;
 
-    ArgumentVector m_args;
+        //! Instance of the given subcommand with its arguments checked.
+        SubcommandUP subcommand;
+    };
 
-    std::string m_helpText;
+    //! State of the latest successful parse. Declared after the arena, as its buffers are in it.
+    std::optional<ParseState> m_parseState;
 
-    HelpSorting m_helpSorting = HelpSorting::None;
+    Stats m_stats;
 
-    OptionDefinitionVector m_optionDefinitions;
+    std::pmr::string m_configFilePath { m_resource };
 
-    std::vector<OptionSet> m_conflictingOptionSets;
+    bool m_configFileRequired = true;
 
-    std::vector<OptionSet> m_optionGroupSets;
+    //! The config file stays mapped until the next parse, or as long as a result refers to it, as the values are views to it.
+    MappedFileSP m_configFile;
 
-    MultiStringCallback m_positionalArgumentCallback = nullptr;
+    //! Filter given to the default help as "--help=FILTER". Views to the arguments.
+    std::string_view m_helpFilter;
+
+    //! Error of the latest parse.
+    Schema::Failure m_failure { &m_parseObjects };
+
+    std::shared_ptr<Schema> m_schema;
+
+    bool m_schemaShared = false;
 
     std::ostream * m_out = &std::cout;
 
     bool m_autoDash = true;
+
+    //! True if parsing a batch on a worker thread.
+    bool m_batch = false;
 };
 
 Argengine::Argengine(int argc, char ** argv, bool addDefaultHelp)
-  : m_impl(new Impl(std::vector<std::string>(argv, argv + argc), addDefaultHelp))
+  : m_impl(new (std::pmr::get_default_resource()) Impl(argv, argv + argc, addDefaultHelp, nullptr))
 {
 }
 
-Argengine::Argengine(ArgumentVector args, bool addDefaultHelp)
-  : m_impl(new Impl(args, addDefaultHelp))
+Argengine::Argengine(int argc, char ** argv, ArgumentStorage argumentStorage, bool addDefaultHelp, std::pmr::memory_resource * memoryResource)
+  : m_impl(argumentStorage == ArgumentStorage::View ? new (resourceOrDefault(memoryResource)) Impl(argc, argv, addDefaultHelp, memoryResource) : new (resourceOrDefault(memoryResource)) Impl(argv, argv + argc, addDefaultHelp, memoryResource))
 {
 }
 
+Argengine::Argengine(ArgumentVector args, bool addDefaultHelp, std::pmr::memory_resource * memoryResource)
+  : m_impl(new (resourceOrDefault(memoryResource)) Impl(args.begin(), args.end(), addDefaultHelp, memoryResource))
+{
+}
+
+Argengine::Argengine(SchemaSP schema, ArgumentVector args, std::pmr::memory_resource * memoryResource)
+  : m_impl(new (resourceOrDefault(memoryResource)) Impl(schema, args, memoryResource))
+{
+}
+
+Argengine::Argengine(const CommandLine & commandLine, bool addDefaultHelp, std::pmr::memory_resource * memoryResource)
+  : m_impl(new (resourceOrDefault(memoryResource)) Impl(commandLine.arguments(), addDefaultHelp, memoryResource))
+{
+}
+
+Argengine::Argengine(SchemaSP schema, const CommandLine & commandLine, std::pmr::memory_resource * memoryResource)
+  : m_impl(new (resourceOrDefault(memoryResource)) Impl(schema, commandLine.arguments(), memoryResource))
+{
+}
+
+Argengine::Argengine(std::unique_ptr<Impl> impl)
+  : m_impl(std::move(impl))
+{
+}
+
+bool Argengine::CommandLine::split(std::string_view commandLine)
+{
+    m_buffer.assign(commandLine);
+    m_arguments.clear();
+    if (!splitInPlace(m_buffer.data(), m_buffer.data() + m_buffer.size(), m_arguments)) {
+        m_arguments.clear();
+        return false;
+    }
+    return true;
+}
+
+Argengine::StringViewSpan Argengine::CommandLine::arguments() const
+{
+    return { m_arguments.data(), m_arguments.size() };
+}
+
 void Argengine::addOption(OptionSet optionVariants, ValuelessCallback callback, bool required, std::string infoText)
 {
-    m_impl->addOption(optionVariants, callback, required, infoText);
+    m_impl->schema().addOption(optionVariants, callback, required, infoText);
 }
 
 void Argengine::addOption(OptionSet optionVariants, SingleStringCallback callback, bool required, std::string infoText, std::string valueName)
 {
-    m_impl->addOption(optionVariants, callback, required, infoText, valueName);
+    m_impl->schema().addOption(optionVariants, callback, required, infoText, valueName);
+}
+
+void Argengine::addOption(OptionSet optionVariants, SingleStringViewCallback callback, bool required, std::string infoText, std::string valueName)
+{
+    m_impl->schema().addOption(optionVariants, callback, required, infoText, valueName);
+}
+
+void Argengine::addOption(OptionSet optionVariants, Arity arity, MultiStringViewCallback callback, bool required, std::string infoText, std::string valueName)
+{
+    m_impl->schema().addOption(optionVariants, arity, callback, required, infoText, valueName);
+}
+
+void Argengine::addTypedOption(OptionSet optionVariants, std::function<void(int64_t)> callback, ValueRange<int64_t> range, bool required, std::string infoText, std::string valueName)
+{
+    m_impl->schema().addTypedOption(optionVariants, callback, range, required, infoText, valueName);
+}
+
+void Argengine::addTypedOption(OptionSet optionVariants, std::function<void(double)> callback, ValueRange<double> range, bool required, std::string infoText, std::string valueName)
+{
+    m_impl->schema().addTypedOption(optionVariants, callback, range, required, infoText, valueName);
+}
+
+void Argengine::addTypedOption(OptionSet optionVariants, std::function<void(bool)> callback, ValueRange<bool> range, bool required, std::string infoText, std::string valueName)
+{
+    m_impl->schema().addTypedOption(optionVariants, callback, range, required, infoText, valueName);
 }
 
 void Argengine::addHelp(OptionSet optionVariants, ValuelessCallback callback)
 {
-    m_impl->addOption(optionVariants, callback, false, SHOW_THIS_HELP_TEXT)->isHelp = true;
+    m_impl->schema().addOption(optionVariants, callback, false, SHOW_THIS_HELP_TEXT)->isHelp = true;
+}
+
+void Argengine::bindEnvironmentVariable(std::string option, std::string variable)
+{
+    m_impl->schema().bindEnvironmentVariable(option, variable);
+}
+
+void Argengine::addSubcommand(std::string name, SubcommandFactory factory, std::string infoText)
+{
+    m_impl->schema().addSubcommand(name, factory, infoText);
 }
 
 void Argengine::addConflictingOptions(OptionSet conflictingOptionSet)
 {
-    m_impl->addConflictingOptions(conflictingOptionSet);
+    m_impl->schema().addConflictingOptions(conflictingOptionSet);
 }
 
 void Argengine::addOptionGroup(OptionSet optionGroup)
 {
-    m_impl->addOptionGroup(optionGroup);
+    m_impl->schema().addOptionGroup(optionGroup);
 }
 
 Argengine::ArgumentVector Argengine::arguments() const
@@ -570,22 +3127,38 @@ Argengine::ArgumentVector Argengine::options() const
 
 void Argengine::setHelpText(std::string helpText)
 {
-    m_impl->setHelpText(helpText);
+    m_impl->schema().setHelpText(helpText);
 }
 
 std::string Argengine::helpText() const
 {
-    return m_impl->helpText();
+    // The const schema, as a shared schema would be copied for the non-const one
+    return std::as_const(*m_impl).schema().helpText();
 }
 
 void Argengine::setHelpSorting(HelpSorting helpSorting)
 {
-    m_impl->setHelpSorting(helpSorting);
+    m_impl->schema().setHelpSorting(helpSorting);
 }
 
 void Argengine::setPositionalArgumentCallback(MultiStringCallback callback)
 {
-    m_impl->setPositionalArgumentCallback(callback);
+    m_impl->schema().setPositionalArgumentCallback(callback);
+}
+
+void Argengine::setPositionalArgumentCallback(MultiStringViewCallback callback, size_t batchSize)
+{
+    m_impl->schema().setPositionalArgumentCallback(callback, batchSize);
+}
+
+void Argengine::setConfigFile(std::string path, bool required)
+{
+    m_impl->setConfigFile(path, required);
+}
+
+void Argengine::setResponseFileExpansion(bool responseFileExpansion)
+{
+    m_impl->schema().setResponseFileExpansion(responseFileExpansion);
 }
 
 void Argengine::setOutputStream(std::ostream & out)
@@ -593,24 +3166,186 @@ void Argengine::setOutputStream(std::ostream & out)
     m_impl->setOutputStream(out);
 }
 
+Argengine::Stats Argengine::stats() const
+{
+    return m_impl->stats();
+}
+
+Argengine::SchemaSP Argengine::compile()
+{
+    return m_impl->compile();
+}
+
 void Argengine::printHelp() const
 {
     m_impl->printHelp();
 }
 
+void Argengine::printHelp(std::string_view filter) const
+{
+    m_impl->printHelp(filter);
+}
+
+void Argengine::setHelpSection(std::string section)
+{
+    m_impl->schema().setHelpSection(section);
+}
+
 void Argengine::parse()
 {
     m_impl->parse();
+    m_impl->throwIfFailed();
 }
 
 void Argengine::parse(Error & error)
 {
-    try {
-        m_impl->parse();
-    } catch (std::runtime_error & e) {
-        error.message = e.what();
-        error.code = Error::Code::Failed;
+    m_impl->catchError(
+      [this] {
+          m_impl->parse();
+      },
+      error);
+}
+
+void Argengine::parse(StringViewSpan args)
+{
+    m_impl->parse(args.begin(), args.end());
+    m_impl->throwIfFailed();
+}
+
+void Argengine::parse(StringViewSpan args, Error & error)
+{
+    m_impl->catchError(
+      [&] {
+          m_impl->parse(args.begin(), args.end());
+      },
+      error);
+}
+
+void Argengine::parse(const ArgumentVector & args)
+{
+    m_impl->parse(args.begin(), args.end());
+    m_impl->throwIfFailed();
+}
+
+void Argengine::parse(const ArgumentVector & args, Error & error)
+{
+    m_impl->catchError(
+      [&] {
+          m_impl->parse(args.begin(), args.end());
+      },
+      error);
+}
+
+Argengine::Error::Code Argengine::tryParse()
+{
+    m_impl->parse();
+    return m_impl->errorCode();
+}
+
+Argengine::Error::Code Argengine::tryParse(StringViewSpan args)
+{
+    m_impl->parse(args.begin(), args.end());
+    return m_impl->errorCode();
+}
+
+std::string Argengine::errorMessage() const
+{
+    return m_impl->errorMessage();
+}
+
+Argengine::ParseResult Argengine::parseResult()
+{
+    auto result = m_impl->createResult();
+    m_impl->parseResult(*result);
+    m_impl->throwIfFailed();
+    return ParseResult { std::move(result) };
+}
+
+Argengine::ParseResult Argengine::parseResult(Error & error)
+{
+    auto result = m_impl->createResult();
+    m_impl->catchError(
+      [&] {
+          m_impl->parseResult(*result);
+      },
+      error);
+    return ParseResult { std::move(result) };
+}
+
+Argengine::ParseResult Argengine::parseResult(StringViewSpan args)
+{
+    auto result = m_impl->createResult();
+    m_impl->parseResult(args, *result);
+    m_impl->throwIfFailed();
+    return ParseResult { std::move(result) };
+}
+
+Argengine::ParseResult Argengine::parseResult(StringViewSpan args, Error & error)
+{
+    auto result = m_impl->createResult();
+    m_impl->catchError(
+      [&] {
+          m_impl->parseResult(args, *result);
+      },
+      error);
+    return ParseResult { std::move(result) };
+}
+
+Argengine::ParseResult::ParseResult(std::unique_ptr<Impl> impl)
+  : m_impl(std::move(impl))
+{
+}
+
+Argengine::ParseResult::ParseResult(ParseResult && other) = default;
+
+Argengine::ParseResult & Argengine::ParseResult::operator=(ParseResult && other) = default;
+
+Argengine::ParseResult::~ParseResult() = default;
+
+bool Argengine::ParseResult::has(std::string_view option) const
+{
+    return m_impl->slot(option) != Impl::NoSlot;
+}
+
+size_t Argengine::ParseResult::count(std::string_view option) const
+{
+    const auto slot = m_impl->slot(option);
+    return slot != Impl::NoSlot ? m_impl->counts.at(slot) : 0;
+}
+
+std::string_view Argengine::ParseResult::value(std::string_view option) const
+{
+    const auto values = this->values(option);
+    return values.empty() ? std::string_view {} : values[values.size() - 1];
+}
+
+Argengine::StringViewSpan Argengine::ParseResult::values(std::string_view option) const
+{
+    if (const auto slot = m_impl->slot(option); slot != Impl::NoSlot) {
+        const auto offset = m_impl->valueOffsets.at(slot);
+        return { m_impl->values.data() + offset, m_impl->valueOffsets.at(slot + 1) - offset };
     }
+    return {};
+}
+
+Argengine::StringViewSpan Argengine::ParseResult::positionalArguments() const
+{
+    return { m_impl->positionalArguments.data(), m_impl->positionalArguments.size() };
+}
+
+std::string_view Argengine::ParseResult::subcommand() const
+{
+    return m_impl->subcommandArguments.empty() ? std::string_view {} : m_impl->subcommandArguments.front();
+}
+
+Argengine::StringViewSpan Argengine::ParseResult::subcommandArguments() const
+{
+    return { m_impl->subcommandArguments.data(), m_impl->subcommandArguments.size() };
+}
+
+std::vector<Argengine::Error> Argengine::parseBatch(SchemaSP schema, const std::string & path, BatchMode mode, size_t threadCount)
+{
+    return Impl::parseBatch(schema, path, mode == BatchMode::Parse, threadCount);
 }
 
 std::string Argengine::version()
@@ -25,12 +25,28 @@
 #ifndef JUZZLIN_ARGENGINE_HPP
 #define JUZZLIN_ARGENGINE_HPP
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ARGENGINE_EXCEPTIONS
+#endif
+
 namespace juzzlin {
 
 //! A simple CLI argument (option) parser library for modern C++ based on lambda callbacks.
@@ -81,11 +97,60 @@ public:
     //! \param addDefaultHelp If true, a default help action for "-h" and "--help" is added.
     Argengine(int argc, char ** argv, bool addDefaultHelp = true);
 
+    //! Storage of the arguments given as argc and argv.
+    enum class ArgumentStorage
+    {
+        //! The arguments are copied.
+        Copy,
+        //! The arguments are only referenced and values are passed on as views (zero-copy). argv must outlive the instance.
+        View
+    };
+
+    //! Constructor.
+    //! \param argc Argument count as in `main(int argc, char ** argv)`
+    //! \param argv Argument array as in `main(int argc, char ** argv)`
+    //! \param argumentStorage Whether the arguments are copied or only referenced.
+    //! \param addDefaultHelp If true, a default help action for "-h" and "--help" is added.
+    //! \param memoryResource Resource for the schema and the parse buffers, see below. Must outlive the instance and its compiled schema.
+    Argengine(int argc, char ** argv, ArgumentStorage argumentStorage, bool addDefaultHelp = true, std::pmr::memory_resource * memoryResource = nullptr);
+
     //! Constructor.
     //! \param args The arguments as a vector of strings. It is assumed, that the first element is the name of the executed application.
     //! \param addDefaultHelp If true, a default help action for "-h" and "--help" is added.
+    //! \param memoryResource Resource for the instance, its copy of the arguments and the schema with its strings and lookup
+    //!                       structures. The buffers of each parse are taken from a monotonic arena on top of it and freed at
+    //!                       once when the next parse starts.
+    //!                       If nullptr, std::pmr::get_default_resource() is used. Must outlive the instance and its compiled schema.
     using ArgumentVector = std::vector<std::string>;
-    explicit Argengine(ArgumentVector args, bool addDefaultHelp = true);
+    explicit Argengine(ArgumentVector args, bool addDefaultHelp = true, std::pmr::memory_resource * memoryResource = nullptr);
+
+    //! Immutable option configuration created by compile().
+    class Schema;
+    using SchemaSP = std::shared_ptr<const Schema>;
+
+    //! Constructor. Creates a parsing instance that uses an already compiled schema without copying it.
+    //! Instances sharing a schema can parse concurrently in different threads, but note that the callbacks are
+    //! then also called concurrently. Adding options to the instance will detach it from the shared schema.
+    //! \param schema The schema returned by compile().
+    //! \param args The arguments as a vector of strings. It is assumed, that the first element is the name of the executed application.
+    //! \param memoryResource Resource for the parse buffers and for the copy made when the instance detaches from the schema.
+    Argengine(SchemaSP schema, ArgumentVector args, std::pmr::memory_resource * memoryResource = nullptr);
+
+    //! Command line given as a single string, see below.
+    class CommandLine;
+
+    //! Zero-copy constructor for a command line given as a single string. The arguments are only referenced,
+    //! so the command line must not be split again or destroyed before the instance.
+    //! \param commandLine The split command line. It is assumed, that the first argument is the name of the executed application.
+    //! \param addDefaultHelp If true, a default help action for "-h" and "--help" is added.
+    //! \param memoryResource Resource for the schema and the parse buffers.
+    explicit Argengine(const CommandLine & commandLine, bool addDefaultHelp = true, std::pmr::memory_resource * memoryResource = nullptr);
+
+    //! Zero-copy constructor for a command line given as a single string and an already compiled schema.
+    //! \param schema The schema returned by compile().
+    //! \param commandLine The split command line. Must not be split again or destroyed before the instance.
+    //! \param memoryResource Resource for the parse buffers and for the copy made when the instance detaches from the schema.
+    Argengine(SchemaSP schema, const CommandLine & commandLine, std::pmr::memory_resource * memoryResource = nullptr);
 
     //! Destructor.
     ~Argengine();
@@ -108,11 +173,74 @@ public:
     using SingleStringCallback = std::function<void(std::string)>;
     void addOption(OptionSet optionVariants, SingleStringCallback callback, bool required = false, std::string infoText = "", std::string valueName = "VALUE");
 
+    //! Adds an option with a single value to the configuration. The value is passed as a view without copying it.
+    //! The view is valid only during the callback.
+    //! \see addOption(OptionSet optionVariants, SingleStringCallback callback, bool required, std::string infoText, std::string valueName).
+    using SingleStringViewCallback = std::function<void(std::string_view)>;
+    void addOption(OptionSet optionVariants, SingleStringViewCallback callback, bool required = false, std::string infoText = "", std::string valueName = "VALUE");
+
+    //! Selects the std::string_view overload for callables taking std::string_view (e.g. lambdas). Otherwise they would
+    //! match both SingleStringCallback and SingleStringViewCallback.
+    template<typename Callback, typename = std::enable_if_t<std::is_invocable_v<Callback, std::string_view>>>
+    void addOption(OptionSet optionVariants, Callback callback, bool required = false, std::string infoText = "", std::string valueName = "VALUE")
+    {
+        addOption(std::move(optionVariants), SingleStringViewCallback { callback }, required, std::move(infoText), std::move(valueName));
+    }
+
+    //! Allowed range of a typed value, inclusive.
+    template<typename T>
+    struct ValueRange
+    {
+        T min = std::numeric_limits<T>::lowest();
+
+        T max = std::numeric_limits<T>::max();
+    };
+
+    //! Adds an option with a single typed value to the configuration. The value is converted with std::from_chars
+    //! without allocating. T must be int64_t, double or bool. Bools accept "1", "0", "true", "false", "yes", "no", "on" and "off".
+    //! If the value can't be converted or is not within the range, parse() fails with Error::Code::InvalidValue or
+    //! Error::Code::OutOfRange and no callbacks are called. A double value of "nan" is always invalid and "inf" is out of
+    //! the default range, so infinity must be included in the range to be accepted.
+    //! \param optionVariants A set of possible options for the given action, usually the short and long form: {"-f", "--foo"}
+    //! \param callback Callback to be called with the converted value. Signature: `void(T)`.
+    //! \param range Allowed range of the value, e.g. { 1, 64 }.
+    //! \param required \see addOption(OptionVariants optionVariants, SingleStringCallback callback, bool required).
+    //! \param infoText Short info text shown in help/usage.
+    //! \param valueName Name of the value in help.
+    template<typename T>
+    void addOption(OptionSet optionVariants, std::function<void(T)> callback, ValueRange<T> range = {}, bool required = false, std::string infoText = "", std::string valueName = "VALUE")
+    {
+        static_assert(std::is_same_v<T, int64_t> || std::is_same_v<T, double> || std::is_same_v<T, bool>, "Typed options must be int64_t, double or bool");
+        addTypedOption(std::move(optionVariants), callback, range, required, std::move(infoText), std::move(valueName));
+    }
+
     //! Special method to add custom help / decorate output of `printHelp()`. Help is always executed first if present.
     //! \param optionVariants A set of possible options for help, usually the short and long form: {"-h", "--help"}
     //! \param callback Callback to be called when the help option has been given. Signature: `void()`.
     void addHelp(OptionSet optionVariants, ValuelessCallback callback);
 
+    //! Binds an environment variable to an option. If the option is not given in the arguments, but the variable is set,
+    //! the value of the variable is used as the value of the option and passed to the same callback. The arguments take
+    //! precedence. The environment is scanned once per parse, and the options taken from it count for required options,
+    //! conflicting options and option groups. A valueless option is applied if the variable is "1", "true", "yes" or "on",
+    //! and ignored if it's empty, "0", "false", "no" or "off".
+    //! \param option Any variant of an already added option, e.g. "--output".
+    //! \param variable Name of the environment variable, e.g. "MYAPP_OUTPUT".
+    void bindEnvironmentVariable(std::string option, std::string variable);
+
+    //! Configures a subcommand. Called with a new instance for the arguments of the subcommand.
+    using SubcommandFactory = std::function<void(Argengine &)>;
+
+    //! Adds a git-style subcommand, e.g. "build" in "tool --verbose build --release". The arguments before the first
+    //! subcommand, that is not a value of an option, are parsed by this instance. The arguments after it are parsed by
+    //! a new instance with its own options, help and constraints. The factory adds them and runs only if the subcommand
+    //! is given. The arguments of both instances are checked before any callbacks are called, and the callbacks of this
+    //! instance are called before those of the subcommand. The subcommands are listed in the help.
+    //! \param name Name of the subcommand, e.g. "build".
+    //! \param factory Factory that adds the options of the subcommand.
+    //! \param infoText Text shown in the help.
+    void addSubcommand(std::string name, SubcommandFactory factory, std::string infoText = "");
+
     //! Adds options that cannot coexist.
     //! \param conflictingOptions A set of possible options that cannot coexist, e.g.: {"--bar", "--foo"}
     void addConflictingOptions(OptionSet conflictingOptionSet);
@@ -150,11 +278,153 @@ public:
     using MultiStringCallback = std::function<void(StringValueVector)>;
     void setPositionalArgumentCallback(MultiStringCallback callback);
 
+    //! Non-owning view to a contiguous sequence of string views, like std::span in C++20.
+    class StringViewSpan
+    {
+    public:
+        StringViewSpan() = default;
+
+        StringViewSpan(const std::string_view * data, size_t size)
+          : m_data(data)
+          , m_size(size)
+        {
+        }
+
+        const std::string_view * begin() const
+        {
+            return m_data;
+        }
+
+        const std::string_view * end() const
+        {
+            return m_data + m_size;
+        }
+
+        const std::string_view & operator[](size_t index) const
+        {
+            return m_data[index];
+        }
+
+        const std::string_view * data() const
+        {
+            return m_data;
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool empty() const
+        {
+            return !m_size;
+        }
+
+    private:
+        const std::string_view * m_data = nullptr;
+
+        size_t m_size = 0;
+    };
+
+    //! Splits a command line given as a single string into arguments as in a POSIX shell: on whitespace, honoring
+    //! single quotes, double quotes and backslash escapes. The arguments are views to an internal buffer where the
+    //! quotes and escapes are removed in place. The buffer is reused by the next split, so repeated splits don't
+    //! allocate once the buffer is large enough.
+    class CommandLine
+    {
+    public:
+        //! Splits the command line. The arguments of the previous split are invalidated.
+        //! \return False if a quote is not terminated. The arguments are then empty.
+        bool split(std::string_view commandLine);
+
+        //! \return Views to the arguments. Valid until the next split.
+        StringViewSpan arguments() const;
+
+    private:
+        std::string m_buffer;
+
+        std::pmr::vector<std::string_view> m_arguments;
+    };
+
+    //! Set handler for positional arguments. The arguments are passed as views without copying them.
+    //! The views are valid only during the callback.
+    //! \param callback Callback to be called with the positional arguments. Signature: `void(StringViewSpan)`.
+    //! \param batchSize If 0, all positional arguments are passed at once after the options have been processed.
+    //!                  Otherwise they are passed in batches of at most batchSize arguments in the order they were
+    //!                  given, interleaved with the option callbacks. E.g. batchSize 1 calls the callback per argument.
+    //!                  All errors (unknown options, conflicts, groups, required options) are checked before the first
+    //!                  callback, so on error no batches are passed at all. Only the granularity of the callback
+    //!                  changes: all arguments are resolved before the first callback, so the memory of the parse
+    //!                  still grows with the number of arguments.
+    using MultiStringViewCallback = std::function<void(StringViewSpan)>;
+    void setPositionalArgumentCallback(MultiStringViewCallback callback, size_t batchSize = 0);
+
+    //! Number of values taken by a multi-value option.
+    struct Arity
+    {
+        static constexpr size_t Unlimited = static_cast<size_t>(-1);
+
+        //! Exactly count values, e.g. "--size 640 480".
+        static constexpr Arity exactly(size_t count)
+        {
+            return { count, count };
+        }
+
+        //! At least count values up to the next option, e.g. "--ids 1 2 3".
+        static constexpr Arity atLeast(size_t count)
+        {
+            return { count, Unlimited };
+        }
+
+        //! Any number of values up to the next option.
+        static constexpr Arity any()
+        {
+            return { 0, Unlimited };
+        }
+
+        size_t min = 1;
+
+        size_t max = Unlimited;
+    };
+
+    //! Adds an option with multiple values to the configuration. The values are taken from the arguments following the
+    //! option until arity.max values have been taken or an option is found. Values of repeated options
+    //! (e.g. "-I a -I b") are accumulated. The callback is called once with all values in a single contiguous buffer
+    //! at the position of the first occurrence. The views are valid only during the callback.
+    //! \param optionVariants A set of possible options for the given action, usually the short and long form: {"-f", "--foo"}
+    //! \param arity Number of values taken by a single occurrence of the option. Too few values is an error.
+    //! \param callback Callback to be called with the values. Signature: `void(StringViewSpan)`.
+    //! \param required \see addOption(OptionVariants optionVariants, SingleStringCallback callback, bool required).
+    //! \param infoText Short info text shown in help/usage.
+    //! \param valueName Name of the value in help.
+    void addOption(OptionSet optionVariants, Arity arity, MultiStringViewCallback callback, bool required = false, std::string infoText = "", std::string valueName = "VALUE");
+
+    //! Enables expansion of response files: an argument "@path" is replaced with the arguments in the given file.
+    //! The arguments in the file are separated by whitespace and can be quoted as in a POSIX shell. The file is mapped
+    //! to memory instead of copying the arguments. Response files can refer to other response files up to 16 levels.
+    //! \param responseFileExpansion If true, response files are expanded. Default is false.
+    void setResponseFileExpansion(bool responseFileExpansion);
+
+    //! Sets a config file read on parse(). Each "key = value" line sets the option whose variant without the leading
+    //! dashes is the key, e.g. "output = out.txt" for "--output". Empty lines, comments starting with '#' or ';' and
+    //! [section] headers are skipped and double quotes around a value are removed. The file is mapped to memory and
+    //! the values are passed to the same callbacks as views to it. The options given in the arguments or taken from
+    //! environment variables take precedence, and the options from the file count for required options, conflicting
+    //! options and option groups. Valueless options take the same values as with bindEnvironmentVariable().
+    //! \param path Path to the config file. An empty path disables the config file.
+    //! \param required If true, parse() fails if the file can't be read. Otherwise a missing file is ignored.
+    void setConfigFile(std::string path, bool required = true);
+
     //! Set custom output stream. Default is std::cout.
     //! \param out The new output stream.
     void setOutputStream(std::ostream & out);
 
-    //! Parses by using the current config. Throws `std::runtime_error` on error.
+    //! Freezes the current configuration so that it can be shared by any number of parsing instances.
+    //! \return The compiled schema. It will not change even if options are added to this instance afterwards.
+    SchemaSP compile();
+
+    //! Parses by using the current config. Throws `std::runtime_error` on error. Without exceptions, e.g. with
+    //! -fno-exceptions, the error is printed and the program aborted instead.
     void parse();
 
     //! Error structure set by parse().
@@ -163,30 +433,609 @@ public:
         enum class Code
         {
             Ok,
-            Failed
+            //! Any other error, e.g. a file that can't be read.
+            Failed,
+            //! The value of a typed option can't be converted, or an environment variable or a config file sets too many
+            //! values for a multi-value option.
+            InvalidValue,
+            //! The value of a typed option is not within the range.
+            OutOfRange,
+            //! An argument is not an option and positional arguments are not accepted, or a key of the config file is
+            //! not an option.
+            UnknownOption,
+            //! No value or too few values given to an option.
+            MissingValue,
+            //! Options of a conflicting option set given.
+            Conflict,
+            //! Only some of the options of an option group given.
+            GroupIncomplete,
+            //! A required option not given.
+            Required
         };
 
         Code code = Code::Ok;
 
         std::string message;
+
+        //! \return True on any error. Before the specific codes, all errors were Code::Failed, so use this instead of
+        //!         comparing to Code::Failed to match any failure.
+        bool failed() const
+        {
+            return code != Code::Ok;
+        }
     };
 
     //! Parses by using the current config.
     //! \param error Contains error info error.
     void parse(Error & error);
 
+    //! Parses the given arguments instead of the ones given to the constructor by using the current config. Can be called
+    //! any number of times on the same instance, e.g. for each command of an interactive shell. The state of the previous
+    //! parse is reset, so the cost of a parse depends on the number of arguments and not on the number of options.
+    //! Throws `std::runtime_error` on error.
+    //! \param args The arguments, e.g. CommandLine::arguments(). It is assumed, that the first element is the name of the
+    //!             executed application. The arguments are only referenced during the parse.
+    void parse(StringViewSpan args);
+
+    //! Same as parse(StringViewSpan args), but sets the error instead of throwing.
+    void parse(StringViewSpan args, Error & error);
+
+    //! Same as parse(StringViewSpan args), but for arguments given as strings.
+    void parse(const ArgumentVector & args);
+
+    //! Same as parse(StringViewSpan args, Error & error), but for arguments given as strings.
+    void parse(const ArgumentVector & args, Error & error);
+
+    //! Parses by using the current config without exceptions, e.g. in validation loops where errors are common.
+    //! Nothing is formatted on error until errorMessage() is called. Exceptions thrown by the callbacks are not caught.
+    //! \return Error::Code::Ok on success.
+    Error::Code tryParse();
+
+    //! Same as tryParse(), but parses the given arguments as parse(StringViewSpan args) does.
+    Error::Code tryParse(StringViewSpan args);
+
+    //! Formats the message of the error of the latest parse. The message refers to the arguments, so they must still
+    //! exist when this is called.
+    //! \return The message or an empty string if the latest parse succeeded.
+    std::string errorMessage() const;
+
+    //! The options and positional arguments of a parse made with parseResult(). The values are views to the arguments,
+    //! so the arguments must outlive the result. The response files and the config file are kept mapped by the result.
+    //! All queries take constant time: an option is looked up by hash and its values are contiguous.
+    class ParseResult
+    {
+    public:
+        ParseResult(ParseResult && other);
+
+        ParseResult & operator=(ParseResult && other);
+
+        ~ParseResult();
+
+        //! \return True if the option was given. Any variant of the option can be used, e.g. "-o" or "--output".
+        bool has(std::string_view option) const;
+
+        //! \return Number of times the option was given.
+        size_t count(std::string_view option) const;
+
+        //! \return The value of the option given last or an empty view if the option was not given or has no value.
+        std::string_view value(std::string_view option) const;
+
+        //! \return The values of all occurrences of the option in the given order, e.g. all values of a multi-value option.
+        StringViewSpan values(std::string_view option) const;
+
+        //! \return The positional arguments.
+        StringViewSpan positionalArguments() const;
+
+        //! \return The given subcommand or an empty view. The factory of the subcommand is not called.
+        std::string_view subcommand() const;
+
+        //! \return The arguments after the subcommand, including the subcommand as the first one.
+        StringViewSpan subcommandArguments() const;
+
+    private:
+        friend class Argengine;
+
+        class Impl;
+
+        explicit ParseResult(std::unique_ptr<Impl> impl);
+
+        std::unique_ptr<Impl> m_impl;
+    };
+
+    //! Parses by using the current config like parse(), but doesn't call any callbacks. The options and positional
+    //! arguments are returned instead. All checks are made as with parse(). The help is not printed, but the help
+    //! option can be queried as any other option. Throws `std::runtime_error` on error.
+    //! \return The result referring to the arguments given to the constructor.
+    ParseResult parseResult();
+
+    //! Same as parseResult(), but sets the error instead of throwing. The result is empty on error.
+    ParseResult parseResult(Error & error);
+
+    //! Same as parseResult(), but parses the given arguments as parse(StringViewSpan args) does.
+    //! \return The result referring to the given arguments.
+    ParseResult parseResult(StringViewSpan args);
+
+    //! Same as parseResult(StringViewSpan args), but sets the error instead of throwing. The result is empty on error.
+    ParseResult parseResult(StringViewSpan args, Error & error);
+
+    //! Mode of parseBatch().
+    enum class BatchMode
+    {
+        //! Only checks the command lines. No callbacks are called.
+        Validate,
+        //! Also calls the callbacks. They are called concurrently from the worker threads, so they must be thread-safe.
+        Parse
+    };
+
+    //! Validates or parses a file of command lines, one per line, against a compiled schema on a pool of threads.
+    //! Each line is split as in a POSIX shell and its first argument is the program name. The file is mapped to
+    //! memory and the lines are split in place without copying. The threads take chunks of lines from a shared
+    //! counter, so that the threads finishing early take over the remaining lines. Each thread reuses a single
+    //! parsing instance. Help options are not processed and the factories of subcommands must be thread-safe.
+    //! \param schema Schema returned by compile().
+    //! \param path Path to the file of command lines.
+    //! \param mode Whether to only validate the lines or to also call the callbacks.
+    //! \param threadCount Number of threads including the calling thread. 0 uses std::thread::hardware_concurrency().
+    //! \return The result of each line in the order of the lines. Empty lines succeed.
+    //! Throws `std::runtime_error` if the file can't be read.
+    static std::vector<Error> parseBatch(SchemaSP schema, const std::string & path, BatchMode mode = BatchMode::Validate, size_t threadCount = 0);
+
+    //! Statistics of the latest parse.
+    struct Stats
+    {
+        //! Allocations made from the memory resource (the heap by default) for the parse: the buffers in the arena,
+        //! including the instance of a given subcommand, the mapped response and config files, the result of
+        //! parseResult() and the details of an error. The buffer of the previous parse is reused, so a repeated parse
+        //! of similar arguments makes none for the buffers. Not included are the values copied for std::string
+        //! callbacks, the formatted error message and the buffer of a file read without mmap.
+        size_t allocations = 0;
+
+        //! Bytes allocated from the memory resource for the parse, see allocations.
+        size_t allocatedBytes = 0;
+
+        //! Bytes used by the buffers of the parse, whether reused or allocated.
+        size_t bufferBytes = 0;
+
+        //! Number of tokens processed after splitting the arguments, not including the application name.
+        size_t tokens = 0;
+
+        //! Number of option definition lookups.
+        size_t lookups = 0;
+
+        //! Time spent in splitting the arguments into tokens, including the expansion of response files.
+        std::chrono::nanoseconds tokenizeTime {};
+
+        //! Time spent in matching the tokens to options and values.
+        std::chrono::nanoseconds resolveTime {};
+
+        //! Time spent in checking conflicting options.
+        std::chrono::nanoseconds conflictCheckTime {};
+
+        //! Time spent in checking option groups.
+        std::chrono::nanoseconds groupCheckTime {};
+
+        //! Time spent in checking required options.
+        std::chrono::nanoseconds requiredCheckTime {};
+
+        //! Time spent in calling the callbacks, including the time spent in the callbacks, or in building the result of parseResult().
+        std::chrono::nanoseconds dispatchTime {};
+    };
+
+    //! \return Statistics of the latest parse. Also valid after a failed parse up to the point of failure.
+    Stats stats() const;
+
     //! Prints help/usage.
     void printHelp() const;
 
+    //! Prints help only for the options matching the filter. The default help does this for "--help=FILTER".
+    //! The filter is, in the order of precedence, an exact option variant (e.g. "--output"), the name of a help section,
+    //! a glob pattern with '*' and '?' (e.g. "--log-*") or a substring of an option variant. The matching lines are
+    //! written from the rendered help without formatting them again, so they are aligned as in the full help.
+    //! \param filter The filter. If empty, the full help is printed.
+    void printHelp(std::string_view filter) const;
+
+    //! Options added after this call belong to the given help section, which can be selected with "--help=SECTION".
+    //! \param section Name of the section. An empty name ends the current section.
+    void setHelpSection(std::string section);
+
     //! \return Library version in x.y.z
     static std::string version();
 
+    //! Option of a compile-time schema, see Static.
+    struct StaticOption
+    {
+        static constexpr size_t MaxVariants = 4;
+
+        //! Variants of the option, e.g. { "-f", "--foo" }. Unused variants are left empty.
+        std::array<std::string_view, MaxVariants> variants {};
+
+        //! If true, the option takes a single value.
+        bool hasValue = false;
+
+        //! If true, an error will follow if the option is not present during parse().
+        bool required = false;
+    };
+
+    //! Compile-time option schema for option sets known at compile time. Nothing is allocated at startup and
+    //! the variants are found with a perfect hash computed at compile time. The formats are the same as with the
+    //! runtime API: "-f 42", "-f=42" and "-f42".
+    //!
+    //! constexpr std::array<Argengine::StaticOption, 2> options = { {
+    //!     { { "-f", "--foo" } },
+    //!     { { "-o", "--output" }, true, true }
+    //! } };
+    //!
+    //! constexpr Argengine::Static<options.size()> schema { options }; // Duplicate variants won't compile
+    //!
+    //! schema.parse(argc, argv, [&](size_t option, std::string_view value) {
+    //!     switch (option) { ... } // option is the index in options or Static::Positional
+    //! });
+    //!
+    template<size_t OptionCount>
+    class Static
+    {
+    public:
+        //! Option index passed to the visitor for positional arguments.
+        static constexpr size_t Positional = static_cast<size_t>(-1);
+
+        //! \param options The options. The index of an option is its id in parse().
+        //! \param acceptPositional If false, arguments that are not options are errors.
+        constexpr explicit Static(const std::array<StaticOption, OptionCount> & options, bool acceptPositional = false)
+          : m_options(options)
+          , m_acceptPositional(acceptPositional)
+        {
+            buildTable();
+            buildPrefixLengths();
+        }
+
+        //! \return Index of the option with the given variant or Positional if not found.
+        constexpr size_t find(std::string_view variant) const
+        {
+            const auto variantHash = hash(variant);
+            const auto & entry = m_table[slot(variantHash, m_displacements[bucket(variantHash)])];
+            return entry.option != Positional && entry.variant == variant ? entry.option : Positional;
+        }
+
+        //! Validates the arguments and then calls the visitor for each option and positional argument in order.
+        //! \param visitor Callable with signature `void(size_t option, std::string_view value)`.
+        //! \param error Contains error info. The visitor is not called at all on error.
+        template<typename Visitor>
+        void parse(int argc, char ** argv, Visitor && visitor, Error & error) const
+        {
+            if (process<false>(argc, argv, visitor, error)) {
+                process<true>(argc, argv, visitor, error);
+            }
+        }
+
+        //! Same as parse(int argc, char ** argv, Visitor && visitor, Error & error), but throws `std::runtime_error` on error.
+        template<typename Visitor>
+        void parse(int argc, char ** argv, Visitor && visitor) const
+        {
+            Error error;
+            parse(argc, argv, visitor, error);
+            if (error.code != Error::Code::Ok) {
+                raise<std::runtime_error>(error.message);
+            }
+        }
+
+    private:
+        static constexpr size_t powerOfTwoAtLeast(size_t count)
+        {
+            size_t size = 1;
+            while (size < count) {
+                size *= 2;
+            }
+            return size;
+        }
+
+        static constexpr size_t MaxKeys = OptionCount * StaticOption::MaxVariants;
+
+        //! Slots of the second level. The load is at most 1 even if all variants are used, and usually about 0.5.
+        static constexpr size_t TableSize = powerOfTwoAtLeast(MaxKeys);
+
+        //! Buckets of the first level, about two variants each.
+        static constexpr size_t BucketCount = powerOfTwoAtLeast(MaxKeys / 4);
+
+        //! Marks a displacement that is the slot of the only variant of its bucket.
+        static constexpr uint64_t DirectSlot = 1ull << 63;
+
+        static constexpr uint64_t hash(std::string_view variant)
+        {
+            uint64_t value = 14695981039346656037ull;
+            for (auto && c : variant) {
+                value ^= static_cast<uint8_t>(c);
+                value *= 1099511628211ull;
+            }
+            return value;
+        }
+
+        static constexpr uint64_t mix(uint64_t value)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        static constexpr size_t bucket(uint64_t hash)
+        {
+            return static_cast<size_t>(mix(hash) >> 32) & (BucketCount - 1);
+        }
+
+        static constexpr size_t slot(uint64_t hash, uint64_t displacement)
+        {
+            return displacement & DirectSlot ? static_cast<size_t>(displacement & ~DirectSlot) : static_cast<size_t>(mix(hash ^ (displacement * 0x9e3779b97f4a7c15ull))) & (TableSize - 1);
+        }
+
+        //! Builds a two-level perfect hash by hashing and displacing. The variants are hashed into buckets, and each
+        //! bucket, the largest first, gets the first seed that maps its variants to free slots. A bucket of a single
+        //! variant takes the next free slot directly. The table is at most half full when the last bucket of several
+        //! variants is placed, so the expected time is linear in the number of variants. Equal variants always fall
+        //! into the same bucket, where they are found as duplicates.
+        constexpr void buildTable()
+        {
+            std::array<uint64_t, MaxKeys> hashes {};
+            std::array<size_t, BucketCount + 1> bucketEnds {};
+            for (size_t key = 0; key < MaxKeys; key++) {
+                if (const auto variant = this->variant(key); !variant.empty()) {
+                    hashes[key] = hash(variant);
+                    bucketEnds[bucket(hashes[key]) + 1]++;
+                }
+            }
+            for (size_t i = 0; i < BucketCount; i++) {
+                bucketEnds[i + 1] += bucketEnds[i];
+            }
+
+            // Keys grouped by bucket
+            std::array<size_t, MaxKeys> keys {};
+            std::array<size_t, BucketCount> bucketFill {};
+            size_t maxBucketSize = 0;
+            for (size_t key = 0; key < MaxKeys; key++) {
+                if (!variant(key).empty()) {
+                    const auto b = bucket(hashes[key]);
+                    keys[bucketEnds[b] + bucketFill[b]++] = key;
+                    maxBucketSize = std::max(bucketFill[b], maxBucketSize);
+                }
+            }
+
+            std::array<size_t, TableSize> slots {};
+            size_t nextFreeSlot = 0;
+            for (size_t size = maxBucketSize; size > 0; size--) {
+                for (size_t b = 0; b < BucketCount; b++) {
+                    if (bucketFill[b] != size) {
+                        continue;
+                    }
+                    const auto first = keys.begin() + static_cast<std::ptrdiff_t>(bucketEnds[b]);
+                    for (size_t i = 0; i < size; i++) {
+                        for (size_t j = i + 1; j < size; j++) {
+                            if (variant(first[i]) == variant(first[j])) {
+                                raise<std::logic_error>("Argengine: Option '" + std::string { variant(first[i]) } + "' already defined!");
+                            }
+                        }
+                    }
+                    if (size == 1) {
+                        while (m_table[nextFreeSlot].option != Positional) {
+                            nextFreeSlot++;
+                        }
+                        m_displacements[b] = nextFreeSlot | DirectSlot;
+                    } else {
+                        m_displacements[b] = findDisplacement(first, size, hashes, slots);
+                    }
+                    for (size_t i = 0; i < size; i++) {
+                        m_table[slot(hashes[first[i]], m_displacements[b])] = { variant(first[i]), first[i] / StaticOption::MaxVariants };
+                    }
+                }
+            }
+        }
+
+        //! \return The first seed that maps the variants of a bucket to different free slots.
+        template<typename Iterator>
+        constexpr uint64_t findDisplacement(Iterator first, size_t size, const std::array<uint64_t, MaxKeys> & hashes, std::array<size_t, TableSize> & slots) const
+        {
+            for (uint64_t seed = 1; seed <= MaxSeed; seed++) {
+                bool free = true;
+                for (size_t i = 0; i < size && free; i++) {
+                    slots[i] = slot(hashes[first[i]], seed);
+                    free = m_table[slots[i]].option == Positional;
+                    for (size_t j = 0; j < i && free; j++) {
+                        free = slots[j] != slots[i];
+                    }
+                }
+                if (free) {
+                    return seed;
+                }
+            }
+            raise<std::logic_error>("Argengine: No perfect hash found!");
+        }
+
+        //! \return The variant of a key, i.e. option * MaxVariants + index of the variant.
+        constexpr std::string_view variant(size_t key) const
+        {
+            return m_options[key / StaticOption::MaxVariants].variants[key % StaticOption::MaxVariants];
+        }
+
+        struct Match
+        {
+            size_t option = Positional;
+
+            std::string_view value;
+
+            bool hasValue = false;
+        };
+
+        //! Collects the distinct lengths of the variants in ascending order, if any option takes a value.
+        constexpr void buildPrefixLengths()
+        {
+            bool hasValueOptions = false;
+            for (auto && option : m_options) {
+                hasValueOptions = hasValueOptions || option.hasValue;
+            }
+            if (!hasValueOptions) {
+                return;
+            }
+            for (auto && option : m_options) {
+                for (auto && variant : option.variants) {
+                    if (variant.empty()) {
+                        continue;
+                    }
+                    size_t i = 0;
+                    while (i < m_prefixLengthCount && m_prefixLengths[i] < variant.size()) {
+                        i++;
+                    }
+                    if (i == m_prefixLengthCount || m_prefixLengths[i] != variant.size()) {
+                        for (size_t j = m_prefixLengthCount; j > i; j--) {
+                            m_prefixLengths[j] = m_prefixLengths[j - 1];
+                        }
+                        m_prefixLengths[i] = variant.size();
+                        m_prefixLengthCount++;
+                    }
+                }
+            }
+        }
+
+        //! Matches an argument in the assignment format, as such or in the spaceless format, in this order.
+        constexpr Match match(std::string_view arg) const
+        {
+            if (const auto pos = arg.find('='); pos != arg.npos) {
+                if (const auto option = find(arg.substr(0, pos)); option != Positional && m_options[option].hasValue) {
+                    return { option, arg.substr(pos + 1), pos + 1 < arg.size() };
+                }
+            }
+            if (const auto option = find(arg); option != Positional) {
+                return { option, {}, false };
+            }
+            // A variant of each length can be a prefix. Valueless variants take part, so that an ambiguous prefix
+            // is rejected as with the runtime API.
+            size_t spacelessOption = Positional;
+            size_t spacelessLength = 0;
+            for (size_t i = 0; i < m_prefixLengthCount && m_prefixLengths[i] < arg.size(); i++) {
+                if (const auto option = find(arg.substr(0, m_prefixLengths[i])); option != Positional) {
+                    if (spacelessOption != Positional && spacelessOption != option) {
+                        return { Positional, {}, false };
+                    }
+                    spacelessOption = option;
+                    spacelessLength = m_prefixLengths[i];
+                }
+            }
+            if (spacelessOption != Positional && m_options[spacelessOption].hasValue) {
+                return { spacelessOption, arg.substr(spacelessLength), true };
+            }
+            return { Positional, {}, false };
+        }
+
+        std::string variantsString(size_t option) const
+        {
+            std::string str;
+            for (auto && variant : m_options[option].variants) {
+                if (!variant.empty()) {
+                    str += (str.empty() ? "" : ", ") + std::string { variant };
+                }
+            }
+            return str;
+        }
+
+        //! Validates the arguments if Dispatch is false, otherwise calls the visitor.
+        template<bool Dispatch, typename Visitor>
+        bool process(int argc, char ** argv, Visitor & visitor, Error & error) const
+        {
+            std::array<bool, OptionCount> applied {};
+            bool endOfOptions = false;
+            for (int i = 1; i < argc; i++) {
+                const std::string_view arg = argv[i];
+                if (!endOfOptions && arg == "--") {
+                    endOfOptions = true;
+                    continue;
+                }
+                const auto argMatch = endOfOptions ? Match { Positional, {}, false } : match(arg);
+                if (argMatch.option == Positional) {
+                    if (!m_acceptPositional) {
+                        return fail(error, Error::Code::UnknownOption, "Unknown option '" + std::string { arg } + "'!");
+                    }
+                    if constexpr (Dispatch) {
+                        visitor(Positional, arg);
+                    }
+                } else {
+                    auto value = argMatch.value;
+                    if (m_options[argMatch.option].hasValue && !argMatch.hasValue) {
+                        if (i + 1 < argc && std::string_view { argv[i + 1] } != "--" && match(argv[i + 1]).option == Positional) {
+                            value = argv[++i];
+                        } else {
+                            return fail(error, Error::Code::MissingValue, "No value for option '" + variantsString(argMatch.option) + "' given!");
+                        }
+                    }
+                    applied[argMatch.option] = true;
+                    if constexpr (Dispatch) {
+                        visitor(argMatch.option, value);
+                    }
+                }
+            }
+            for (size_t i = 0; i < OptionCount; i++) {
+                if (m_options[i].required && !applied[i]) {
+                    return fail(error, Error::Code::Required, "Option '" + variantsString(i) + "' is required!");
+                }
+            }
+            return true;
+        }
+
+        static bool fail(Error & error, Error::Code code, const std::string & message)
+        {
+            error.code = code;
+            error.message = "Argengine: " + message;
+            return false;
+        }
+
+        //! Throws the exception. Without exceptions the message is printed and the program aborted. Not a constant
+        //! expression, so an error found at compile time won't compile either way.
+        template<typename Exception>
+        [[noreturn]] static void raise(const std::string & message)
+        {
+#ifdef ARGENGINE_EXCEPTIONS
+            throw Exception(message);
+#else
+            std::fprintf(stderr, "%s\n", message.c_str());
+            std::abort();
+#endif
+        }
+
+        //! Seeds tried per bucket before giving up. Practically never reached.
+        static constexpr uint64_t MaxSeed = 65536;
+
+        struct Entry
+        {
+            std::string_view variant;
+
+            size_t option = Positional;
+        };
+
+        std::array<StaticOption, OptionCount> m_options {};
+
+        std::array<Entry, TableSize> m_table {};
+
+        //! Seed or direct slot of each bucket.
+        std::array<uint64_t, BucketCount> m_displacements {};
+
+        //! Distinct lengths of the variants for the spaceless format. Empty if no option takes a value.
+        std::array<size_t, OptionCount * StaticOption::MaxVariants> m_prefixLengths {};
+
+        size_t m_prefixLengthCount = 0;
+
+        bool m_acceptPositional = false;
+    };
+
 private:
+    void addTypedOption(OptionSet optionVariants, std::function<void(int64_t)> callback, ValueRange<int64_t> range, bool required, std::string infoText, std::string valueName);
+
+    void addTypedOption(OptionSet optionVariants, std::function<void(double)> callback, ValueRange<double> range, bool required, std::string infoText, std::string valueName);
+
+    void addTypedOption(OptionSet optionVariants, std::function<void(bool)> callback, ValueRange<bool> range, bool required, std::string infoText, std::string valueName);
+
     Argengine(const Argengine & r) = delete;
     Argengine & operator=(const Argengine & r) = delete;
 
     class Impl;
     std::unique_ptr<Impl> m_impl;
+
+    explicit Argengine(std::unique_ptr<Impl> impl);
 };
 
 } // juzzlin
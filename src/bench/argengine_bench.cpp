@@ -0,0 +1,380 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../argengine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using juzzlin::Argengine;
+
+//
+// Parse-performance benchmark. Sweeps the number of options, the number of arguments, the format of the
+// arguments, the number of conflicting option sets and option groups, failing parses and the number of threads of a batch.
+// Prints one JSON object per case.
+//
+
+namespace {
+
+std::atomic<size_t> allocationCount {};
+
+std::atomic<size_t> allocatedBytes {};
+
+} // namespace
+
+void * operator new(size_t size)
+{
+    allocationCount++;
+    allocatedBytes += size;
+    if (void * ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// The std::pmr resources of the parser allocate with an alignment
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    allocationCount++;
+    allocatedBytes += size;
+    const auto align = static_cast<size_t>(alignment);
+    if (void * ptr = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+enum class Format
+{
+    Assignment, // --x=v
+    Spaceless, // --xv
+    Space, // --x v
+    Positional // v
+};
+
+const char * formatName(Format format)
+{
+    switch (format) {
+    case Format::Assignment:
+        return "assignment";
+    case Format::Spaceless:
+        return "spaceless";
+    case Format::Space:
+        return "space";
+    case Format::Positional:
+        return "positional";
+    }
+    return "";
+}
+
+struct Case
+{
+    std::string sweep;
+
+    size_t optionCount = 100;
+
+    size_t argumentCount = 1000;
+
+    Format format = Format::Space;
+
+    size_t constraintCount = 0;
+};
+
+// The variants end with ':' so that none of them is a prefix of another one in the spaceless format
+std::string optionName(size_t index)
+{
+    return "--o" + std::to_string(index) + ":";
+}
+
+Argengine::ArgumentVector createArguments(const Case & benchCase)
+{
+    Argengine::ArgumentVector args { "bench" };
+    // Only the first half of the options are given, so that the conflicts can refer to the second half
+    const size_t givenOptions = std::max<size_t>(benchCase.optionCount / 2, 1);
+    for (size_t i = 0; args.size() <= benchCase.argumentCount; i++) {
+        const auto option = optionName(i % givenOptions);
+        switch (benchCase.format) {
+        case Format::Assignment:
+            args.push_back(option + "=" + std::to_string(i));
+            break;
+        case Format::Spaceless:
+            args.push_back(option + std::to_string(i));
+            break;
+        case Format::Space:
+            args.push_back(option);
+            args.push_back(std::to_string(i));
+            break;
+        case Format::Positional:
+            args.push_back("file" + std::to_string(i));
+            break;
+        }
+    }
+    args.resize(benchCase.argumentCount + 1);
+    return args;
+}
+
+size_t peakRssKb()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return 0;
+#endif
+}
+
+void runCase(const Case & benchCase, size_t repetitions)
+{
+    const auto args = createArguments(benchCase);
+    Argengine ae(args, false);
+    size_t sink = 0;
+    for (size_t i = 0; i < benchCase.optionCount; i++) {
+        ae.addOption({ optionName(i) }, [&sink](std::string_view value) {
+            sink += value.size();
+        });
+    }
+    for (size_t i = 0; i < benchCase.constraintCount; i++) {
+        const auto first = i % benchCase.optionCount;
+        const auto second = (i + benchCase.optionCount / 2) % benchCase.optionCount;
+        if (i % 2) {
+            ae.addConflictingOptions({ optionName(first), optionName(second) });
+        } else {
+            ae.addOptionGroup({ optionName(second), optionName((second + 1) % benchCase.optionCount) });
+        }
+    }
+    ae.setPositionalArgumentCallback([&sink](Argengine::StringViewSpan positionalArguments) {
+        sink += positionalArguments.size();
+    });
+
+    ae.parse(); // Warm-up
+
+    const size_t allocationCountBefore = allocationCount;
+    const size_t allocatedBytesBefore = allocatedBytes;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; i++) {
+        ae.parse();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const auto nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+
+    std::cout << "{\"sweep\": \"" << benchCase.sweep << "\""
+              << ", \"options\": " << benchCase.optionCount
+              << ", \"arguments\": " << benchCase.argumentCount
+              << ", \"format\": \"" << formatName(benchCase.format) << "\""
+              << ", \"constraints\": " << benchCase.constraintCount
+              << ", \"ns_per_arg\": " << nanoseconds / static_cast<double>(repetitions * benchCase.argumentCount)
+              << ", \"allocations_per_parse\": " << static_cast<double>(allocationCount - allocationCountBefore) / static_cast<double>(repetitions)
+              << ", \"bytes_per_parse\": " << static_cast<double>(allocatedBytes - allocatedBytesBefore) / static_cast<double>(repetitions)
+              << ", \"peak_rss_kb\": " << peakRssKb()
+              << "}" << std::endl;
+
+    if (!sink) {
+        std::cerr << "Nothing parsed!" << std::endl;
+    }
+}
+
+//! Parses arguments ending with an unknown option, either only getting the code or also formatting the message.
+void runErrorCase(bool formatMessage, size_t repetitions)
+{
+    Case benchCase;
+    benchCase.argumentCount = 100;
+    auto args = createArguments(benchCase);
+    args.push_back("--unknown");
+    Argengine ae(args, false);
+    for (size_t i = 0; i < benchCase.optionCount; i++) {
+        ae.addOption({ optionName(i) }, [](std::string_view) {
+        });
+    }
+
+    size_t failures = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; i++) {
+        if (formatMessage) {
+            Argengine::Error error;
+            ae.parse(error);
+            failures += !error.message.empty();
+        } else {
+            failures += ae.tryParse() != Argengine::Error::Code::Ok;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const auto nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+
+    std::cout << "{\"sweep\": \"errors\""
+              << ", \"message\": " << (formatMessage ? "true" : "false")
+              << ", \"arguments\": " << benchCase.argumentCount
+              << ", \"ns_per_parse\": " << nanoseconds / static_cast<double>(repetitions)
+              << "}" << std::endl;
+
+    if (failures != repetitions) {
+        std::cerr << "Parse didn't fail!" << std::endl;
+    }
+}
+
+void runBatchCase(const std::string & path, size_t lineCount, size_t threadCount)
+{
+    Argengine ae({ "bench" }, false);
+    for (size_t i = 0; i < 100; i++) {
+        ae.addOption({ optionName(i) }, [](std::string_view) {
+        });
+    }
+    const auto schema = ae.compile();
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto errors = Argengine::parseBatch(schema, path, Argengine::BatchMode::Validate, threadCount);
+    const auto end = std::chrono::steady_clock::now();
+    const auto nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+
+    std::cout << "{\"sweep\": \"batch\""
+              << ", \"threads\": " << threadCount
+              << ", \"lines\": " << lineCount
+              << ", \"ns_per_line\": " << nanoseconds / static_cast<double>(lineCount)
+              << ", \"peak_rss_kb\": " << peakRssKb()
+              << "}" << std::endl;
+
+    if (std::any_of(errors.begin(), errors.end(), [](auto && error) {
+            return error.code != Argengine::Error::Code::Ok;
+        })) {
+        std::cerr << "Batch failed!" << std::endl;
+    }
+}
+
+void runBatchCases(size_t lineCount)
+{
+    // Lines of ten options with values
+    const auto path = (std::filesystem::temp_directory_path() / "argengine_bench_batch.txt").string();
+    {
+        std::ofstream out { path, std::ios::binary };
+        for (size_t i = 0; i < lineCount; i++) {
+            out << "bench";
+            for (size_t j = 0; j < 10; j++) {
+                out << ' ' << optionName((i + j) % 100) << ' ' << j;
+            }
+            out << '\n';
+        }
+    }
+
+    const size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        runBatchCase(path, lineCount, threadCount);
+    }
+
+    std::filesystem::remove(path);
+}
+
+int main(int argc, char ** argv)
+{
+    bool quick = false;
+    size_t argumentBudget = 10000000;
+    Argengine ae(argc, argv);
+    ae.setHelpText("Usage: " + std::string { argv[0] } + " [OPTIONS]\n\nRuns the parse-performance benchmark and prints the results as JSON lines.");
+    ae.addOption(
+      { "-q", "--quick" }, [&] {
+          quick = true;
+      },
+      false, "Run smaller sweeps, e.g. for CI.");
+    ae.addOption(
+      { "-b", "--budget" }, [&](std::string value) {
+          argumentBudget = std::stoul(value);
+      },
+      false, "Total number of arguments parsed per case. Default is 10000000.", "COUNT");
+    ae.parse();
+
+    const size_t maxOptions = quick ? 1000 : 10000;
+    const size_t maxArguments = quick ? 10000 : 1000000;
+    const auto repetitionsFor = [=](const Case & benchCase) {
+        return std::max<size_t>(argumentBudget / benchCase.argumentCount / (quick ? 100 : 1), 1);
+    };
+
+    for (size_t optionCount = 10; optionCount <= maxOptions; optionCount *= 10) {
+        Case benchCase;
+        benchCase.sweep = "options";
+        benchCase.optionCount = optionCount;
+        runCase(benchCase, repetitionsFor(benchCase));
+    }
+
+    for (size_t argumentCount = 10; argumentCount <= maxArguments; argumentCount *= 10) {
+        Case benchCase;
+        benchCase.sweep = "arguments";
+        benchCase.argumentCount = argumentCount;
+        runCase(benchCase, repetitionsFor(benchCase));
+    }
+
+    for (auto && format : { Format::Assignment, Format::Spaceless, Format::Space, Format::Positional }) {
+        Case benchCase;
+        benchCase.sweep = "format";
+        benchCase.format = format;
+        runCase(benchCase, repetitionsFor(benchCase));
+    }
+
+    for (size_t constraintCount = 10; constraintCount <= maxOptions; constraintCount *= 10) {
+        Case benchCase;
+        benchCase.sweep = "constraints";
+        benchCase.optionCount = maxOptions;
+        benchCase.constraintCount = constraintCount;
+        runCase(benchCase, repetitionsFor(benchCase));
+    }
+
+    for (auto && formatMessage : { false, true }) {
+        runErrorCase(formatMessage, quick ? 1000 : 100000);
+    }
+
+    runBatchCases(quick ? 10000 : 1000000);
+
+    return EXIT_SUCCESS;
+}
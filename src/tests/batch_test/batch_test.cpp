@@ -0,0 +1,124 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+#include "../test_file.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+Argengine::SchemaSP createSchema(std::atomic<size_t> & calls)
+{
+    Argengine ae({ "test" });
+    ae.addOption({ "-a" }, [&calls] {
+        calls++;
+    });
+    ae.addOption(
+      { "-f", "--foo" }, [&calls](std::string_view) {
+          calls++;
+      },
+      true);
+    ae.addConflictingOptions({ "-a", "--bar" });
+    ae.addOption({ "--bar" }, [&calls] {
+        calls++;
+    });
+    return ae.compile();
+}
+
+void testBatch_Validate_ShouldReturnErrorsInOrder()
+{
+    const auto path = writeFile("argengine_batch_1.txt", "tool -f 1\ntool -a\n\ntool -f \"x y\" -a\ntool -f 1 -a --bar\ntool -x -f 1\ntool -f 'x\n");
+    std::atomic<size_t> calls {};
+    const auto errors = Argengine::parseBatch(createSchema(calls), path);
+    assert(errors.size() == 7);
+    assert(errors.at(0).code == Argengine::Error::Code::Ok);
+    assert(errors.at(1).code == Argengine::Error::Code::Required);
+    assert(errors.at(1).message == std::string(name) + ": Option '-f, --foo' is required!");
+    assert(errors.at(2).code == Argengine::Error::Code::Ok);
+    assert(errors.at(3).code == Argengine::Error::Code::Ok);
+    assert(errors.at(4).code == Argengine::Error::Code::Conflict);
+    assert(errors.at(4).message == std::string(name) + ": Conflicting options: '--bar', '-a'. These options cannot coexist.");
+    assert(errors.at(5).code == Argengine::Error::Code::UnknownOption);
+    assert(errors.at(5).message == std::string(name) + ": Unknown option '-x'!");
+    assert(errors.at(6).message == std::string(name) + ": Line 7 has an unterminated quote!");
+    assert(calls == 0);
+    std::filesystem::remove(path);
+}
+
+void testBatch_Parse_ShouldCallCallbacks()
+{
+    std::string content;
+    const size_t lineCount = 10000;
+    for (size_t i = 0; i < lineCount; i++) {
+        content += i % 7 ? "tool -a --foo=" + std::to_string(i) + "\n" : "tool -a\n";
+    }
+    const auto path = writeFile("argengine_batch_2.txt", content);
+    std::atomic<size_t> calls {};
+    const auto errors = Argengine::parseBatch(createSchema(calls), path, Argengine::BatchMode::Parse, 4);
+    assert(errors.size() == lineCount);
+    size_t failed = 0;
+    for (size_t i = 0; i < lineCount; i++) {
+        assert((errors.at(i).code == Argengine::Error::Code::Ok) == static_cast<bool>(i % 7));
+        failed += !(i % 7);
+    }
+    assert(calls == (lineCount - failed) * 2);
+    std::filesystem::remove(path);
+}
+
+void testBatch_MissingFile_ShouldFail()
+{
+    const auto path = (std::filesystem::temp_directory_path() / "argengine_batch_missing.txt").string();
+    std::atomic<size_t> calls {};
+    std::string error;
+    try {
+        Argengine::parseBatch(createSchema(calls), path);
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Batch file '" + path + "' cannot be read!");
+}
+
+int main(int, char **)
+{
+    testBatch_Validate_ShouldReturnErrorsInOrder();
+
+    testBatch_Parse_ShouldCallCallbacks();
+
+    testBatch_MissingFile_ShouldFail();
+
+    return EXIT_SUCCESS;
+}
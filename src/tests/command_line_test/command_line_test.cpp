@@ -0,0 +1,126 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+std::vector<std::string> toVector(Argengine::StringViewSpan arguments)
+{
+    return { arguments.begin(), arguments.end() };
+}
+
+void testCommandLine_QuotesAndEscapes_ShouldSucceed()
+{
+    Argengine::CommandLine commandLine;
+    assert(commandLine.split("  app -a\t'x y' \"a\\\"b $c\" c\\ d '' e\"f\"'g' -- \n"));
+    assert(toVector(commandLine.arguments()) == std::vector<std::string>({ "app", "-a", "x y", "a\"b $c", "c d", "", "efg", "--" }));
+}
+
+void testCommandLine_UnterminatedQuote_ShouldFail()
+{
+    Argengine::CommandLine commandLine;
+    assert(commandLine.split("app a"));
+    assert(!commandLine.split("app 'a b"));
+    assert(commandLine.arguments().empty());
+    assert(!commandLine.split("app \"a b"));
+}
+
+void testCommandLine_SplitAgain_ShouldReplaceArguments()
+{
+    Argengine::CommandLine commandLine;
+    assert(commandLine.split("app --long-option-name value1 value2 value3"));
+    assert(commandLine.arguments().size() == 5);
+    assert(commandLine.split("app -a"));
+    assert(toVector(commandLine.arguments()) == std::vector<std::string>({ "app", "-a" }));
+    assert(commandLine.split(""));
+    assert(commandLine.arguments().empty());
+}
+
+void testCommandLine_Parse_ShouldSucceed()
+{
+    Argengine::CommandLine commandLine;
+    assert(commandLine.split("app -f \"foo bar\" --level=2 file -- -f"));
+    Argengine ae(commandLine);
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-f" }, [&](std::string_view value) {
+        values["f"] = value;
+    });
+    ae.addOption({ "--level" }, [&](std::string value) {
+        values["level"] = value;
+    });
+    Argengine::ArgumentVector ps;
+    ae.setPositionalArgumentCallback([&](Argengine::ArgumentVector args) {
+        ps = args;
+    });
+    ae.parse();
+    assert(values["f"] == "foo bar");
+    assert(values["level"] == "2");
+    assert(ps == Argengine::ArgumentVector({ "file", "-f" }));
+    assert(ae.arguments().at(2) == "foo bar");
+}
+
+void testCommandLine_ParseWithSchema_ShouldSucceed()
+{
+    std::vector<std::string> values;
+    Argengine configuration({ "app" });
+    configuration.addOption({ "-f" }, [&](std::string_view value) {
+        values.emplace_back(value);
+    });
+    const auto schema = configuration.compile();
+    Argengine::CommandLine commandLine;
+    for (auto && line : { "app -f 'a b'", "app -f c", "app -fd" }) {
+        assert(commandLine.split(line));
+        Argengine ae(schema, commandLine);
+        ae.parse();
+    }
+    assert(values == std::vector<std::string>({ "a b", "c", "d" }));
+}
+
+int main(int, char **)
+{
+    testCommandLine_QuotesAndEscapes_ShouldSucceed();
+
+    testCommandLine_UnterminatedQuote_ShouldFail();
+
+    testCommandLine_SplitAgain_ShouldReplaceArguments();
+
+    testCommandLine_Parse_ShouldSucceed();
+
+    testCommandLine_ParseWithSchema_ShouldSucceed();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+#include "../test_file.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testConfigFile_KeysAndValues_ShouldSucceed()
+{
+    const auto path = writeFile("argengine_cf_1.ini", "# Comment\n; Comment\n\n[general]\noutput = out.txt\n  jobs=8  \r\nname = \"foo bar\"\nv = yes\nq = off\n");
+    Argengine ae({ "test" });
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-o", "--output" }, [&](std::string_view value) {
+        values["output"] = value;
+    });
+    int64_t jobs {};
+    ae.addOption<int64_t>({ "-j", "--jobs" }, [&](int64_t value) {
+        jobs = value;
+    });
+    ae.addOption({ "--name" }, [&](std::string value) {
+        values["name"] = value;
+    });
+    ae.addOption({ "-v" }, [&] {
+        values["v"] = "called";
+    });
+    ae.addOption({ "-q" }, [&] {
+        values["q"] = "called";
+    });
+    ae.setConfigFile(path);
+    ae.parse();
+    assert(values["output"] == "out.txt");
+    assert(jobs == 8);
+    assert(values["name"] == "foo bar");
+    assert(values["v"] == "called");
+    assert(!values.count("q"));
+    std::filesystem::remove(path);
+}
+
+void testConfigFile_OptionGiven_ShouldTakePrecedence()
+{
+    const auto path = writeFile("argengine_cf_2.ini", "output = file.txt\nlevel = file\n");
+    setenv("ARGENGINE_TEST_LEVEL", "env", 1);
+    Argengine ae({ "test", "--output", "argv.txt" });
+    size_t calls {};
+    std::map<std::string, std::string> values;
+    ae.addOption({ "--output" }, [&](std::string value) {
+        calls++;
+        values["output"] = value;
+    });
+    ae.addOption({ "--level" }, [&](std::string value) {
+        calls++;
+        values["level"] = value;
+    });
+    ae.bindEnvironmentVariable("--level", "ARGENGINE_TEST_LEVEL");
+    ae.setConfigFile(path);
+    ae.parse();
+    assert(calls == 2);
+    assert(values["output"] == "argv.txt");
+    assert(values["level"] == "env");
+    unsetenv("ARGENGINE_TEST_LEVEL");
+    std::filesystem::remove(path);
+}
+
+void testConfigFile_RequiredFromFile_ShouldSucceed()
+{
+    const auto path = writeFile("argengine_cf_3.ini", "foo = 42\n");
+    Argengine ae({ "test" });
+    std::string foo;
+    ae.addOption(
+      { "-f", "--foo" }, [&](std::string value) {
+          foo = value;
+      },
+      true);
+    ae.setConfigFile(path);
+    ae.parse();
+    assert(foo == "42");
+    std::filesystem::remove(path);
+}
+
+void testConfigFile_UnknownKey_ShouldFail()
+{
+    const auto path = writeFile("argengine_cf_4.ini", "foo = 1\n\nbar = 2\n");
+    Argengine ae({ "test" });
+    ae.addOption({ "--foo" }, [](std::string) {
+    });
+    ae.setConfigFile(path);
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Config file '" + path + "' line 3: Unknown option 'bar'!");
+    std::filesystem::remove(path);
+}
+
+void testConfigFile_MalformedLine_ShouldFail()
+{
+    const auto path = writeFile("argengine_cf_5.ini", "foo = 1\nfoo\n");
+    Argengine ae({ "test" });
+    bool called {};
+    ae.addOption({ "--foo" }, [&](std::string) {
+        called = true;
+    });
+    ae.setConfigFile(path);
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(!called);
+    assert(error == std::string(name) + ": Config file '" + path + "' line 2: Expected 'key = value'!");
+    std::filesystem::remove(path);
+}
+
+void testConfigFile_MissingRequiredFile_ShouldFail()
+{
+    const auto path = (std::filesystem::temp_directory_path() / "argengine_cf_missing.ini").string();
+    Argengine ae({ "test" });
+    ae.setConfigFile(path);
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Config file '" + path + "' cannot be read!");
+}
+
+void testConfigFile_MissingOptionalFile_ShouldSucceed()
+{
+    const auto path = (std::filesystem::temp_directory_path() / "argengine_cf_missing.ini").string();
+    Argengine ae({ "test", "-a" });
+    bool called {};
+    ae.addOption({ "-a" }, [&] {
+        called = true;
+    });
+    ae.setConfigFile(path, false);
+    ae.parse();
+    assert(called);
+}
+
+void testConfigFile_MultiValueKey_ShouldCheckArity()
+{
+    const auto path = writeFile("argengine_cf_6.ini", "size = 640 480\ninclude = a\n");
+    Argengine ae({ "test" });
+    std::vector<std::string> size;
+    ae.addOption({ "--size" }, Argengine::Arity::exactly(2), [&](Argengine::StringViewSpan values) {
+        size = { values.begin(), values.end() };
+    });
+    ae.addOption({ "--include" }, Argengine::Arity::atLeast(2), [](Argengine::StringViewSpan) {
+    });
+    ae.setConfigFile(path);
+    Argengine::Error error;
+    ae.parse(error);
+    assert(error.code == Argengine::Error::Code::MissingValue);
+    assert(size.empty());
+    std::filesystem::remove(path);
+}
+
+int main(int, char **)
+{
+    testConfigFile_KeysAndValues_ShouldSucceed();
+
+    testConfigFile_OptionGiven_ShouldTakePrecedence();
+
+    testConfigFile_RequiredFromFile_ShouldSucceed();
+
+    testConfigFile_UnknownKey_ShouldFail();
+
+    testConfigFile_MalformedLine_ShouldFail();
+
+    testConfigFile_MissingRequiredFile_ShouldFail();
+
+    testConfigFile_MissingOptionalFile_ShouldSucceed();
+
+    testConfigFile_MultiValueKey_ShouldCheckArity();
+
+    return EXIT_SUCCESS;
+}
@@ -32,6 +32,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <stdexcept>
+#include <string>
 
 using juzzlin::Argengine;
 
@@ -110,6 +111,60 @@ void testConflictingArguments_ConflictingArgumentsGiven_ShouldNotReferToVariants
     assert(error == std::string(name) + ": Conflicting options: '" + a2 + "', '" + a3 + "'. These options cannot coexist.");
 }
 
+void testConflictingArguments_SetAddedBeforeOptions_ShouldFail()
+{
+    Argengine ae({ "a1", "--a2", "-a3" });
+    std::string error;
+    ae.addConflictingOptions({ "-a2", "-a3" });
+    ae.addOption({ "-a2", "--a2" }, [] {
+    });
+    ae.addOption({ "-a3" }, [] {
+    });
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Conflicting options: '-a2', '-a3'. These options cannot coexist.");
+}
+
+void testConflictingArguments_ManySets_ShouldFailOnFirstConflictingSet()
+{
+    Argengine ae({ "test", "-o7", "-o3", "-o5" });
+    for (size_t i = 0; i < 100; i++) {
+        ae.addOption({ "-o" + std::to_string(i) }, [] {
+        });
+    }
+    for (size_t i = 0; i < 100; i++) {
+        ae.addConflictingOptions({ "-o" + std::to_string(i), "-o" + std::to_string((i + 2) % 100) });
+    }
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Conflicting options: '-o3', '-o5'. These options cannot coexist.");
+}
+
+void testConflictingArguments_AddedAfterParse_ShouldFail()
+{
+    Argengine ae({ "test", "-a", "-b" });
+    ae.addOption({ "-a" }, [] {
+    });
+    ae.addOption({ "-b" }, [] {
+    });
+    ae.parse();
+    ae.addConflictingOptions({ "-a", "-b" });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Conflicting options: '-a', '-b'. These options cannot coexist.");
+}
+
 int main(int, char **)
 {
     testConflictingArguments_ConflictingArgumentsGiven_ShouldFail();
@@ -118,5 +173,11 @@ int main(int, char **)
 
     testConflictingArguments_ConflictingArgumentsGiven_ShouldNotReferToVariants();
 
+    testConflictingArguments_SetAddedBeforeOptions_ShouldFail();
+
+    testConflictingArguments_ManySets_ShouldFailOnFirstConflictingSet();
+
+    testConflictingArguments_AddedAfterParse_ShouldFail();
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,211 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testEnvironment_VariableSet_ShouldUseValue()
+{
+    setenv("ARGENGINE_TEST_OUTPUT", "out.txt", 1);
+    setenv("ARGENGINE_TEST_JOBS", "8", 1);
+    Argengine ae({ "test" });
+    std::string output;
+    ae.addOption({ "-o", "--output" }, [&](std::string value) {
+        output = value;
+    });
+    int64_t jobs {};
+    ae.addOption<int64_t>({ "-j" }, [&](int64_t value) {
+        jobs = value;
+    });
+    ae.bindEnvironmentVariable("--output", "ARGENGINE_TEST_OUTPUT");
+    ae.bindEnvironmentVariable("-j", "ARGENGINE_TEST_JOBS");
+    ae.parse();
+    assert(output == "out.txt");
+    assert(jobs == 8);
+    unsetenv("ARGENGINE_TEST_OUTPUT");
+    unsetenv("ARGENGINE_TEST_JOBS");
+}
+
+void testEnvironment_OptionGiven_ShouldTakePrecedence()
+{
+    setenv("ARGENGINE_TEST_OUTPUT", "env.txt", 1);
+    Argengine ae({ "test", "-o", "argv.txt" });
+    size_t calls {};
+    std::string output;
+    ae.addOption({ "-o" }, [&](std::string value) {
+        calls++;
+        output = value;
+    });
+    ae.bindEnvironmentVariable("-o", "ARGENGINE_TEST_OUTPUT");
+    ae.parse();
+    assert(calls == 1);
+    assert(output == "argv.txt");
+    unsetenv("ARGENGINE_TEST_OUTPUT");
+}
+
+void testEnvironment_RequiredFromVariable_ShouldSucceed()
+{
+    setenv("ARGENGINE_TEST_VERBOSE", "yes", 1);
+    setenv("ARGENGINE_TEST_QUIET", "0", 1);
+    Argengine ae({ "test" });
+    bool verbose {};
+    ae.addOption(
+      { "-v" }, [&] {
+          verbose = true;
+      },
+      true);
+    bool quiet {};
+    ae.addOption({ "-q" }, [&] {
+        quiet = true;
+    });
+    ae.bindEnvironmentVariable("-v", "ARGENGINE_TEST_VERBOSE");
+    ae.bindEnvironmentVariable("-q", "ARGENGINE_TEST_QUIET");
+    ae.parse();
+    assert(verbose);
+    assert(!quiet);
+    unsetenv("ARGENGINE_TEST_VERBOSE");
+    unsetenv("ARGENGINE_TEST_QUIET");
+}
+
+void testEnvironment_ConflictWithArgument_ShouldFail()
+{
+    setenv("ARGENGINE_TEST_QUIET", "1", 1);
+    Argengine ae({ "test", "-v" });
+    ae.addOption({ "-v" }, [] {
+    });
+    ae.addOption({ "-q" }, [] {
+    });
+    ae.addConflictingOptions({ "-q", "-v" });
+    ae.bindEnvironmentVariable("-q", "ARGENGINE_TEST_QUIET");
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Conflicting options: '-q', '-v'. These options cannot coexist.");
+    unsetenv("ARGENGINE_TEST_QUIET");
+}
+
+void testEnvironment_UnknownOption_ShouldThrow()
+{
+    Argengine ae({ "test" });
+    std::string error;
+    try {
+        ae.bindEnvironmentVariable("-x", "ARGENGINE_TEST_X");
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Unknown option '-x'!");
+}
+
+void testEnvironment_CompiledSchema_ShouldUseVariable()
+{
+    setenv("ARGENGINE_TEST_OUTPUT", "out.txt", 1);
+    std::string output;
+    Argengine ae({ "test" });
+    ae.addOption({ "-o" }, [&](std::string_view value) {
+        output = value;
+    });
+    ae.bindEnvironmentVariable("-o", "ARGENGINE_TEST_OUTPUT");
+    const auto schema = ae.compile();
+    Argengine instance(schema, { "test" });
+    instance.addOption({ "-x" }, [] {
+    });
+    instance.parse();
+    assert(output == "out.txt");
+    unsetenv("ARGENGINE_TEST_OUTPUT");
+}
+
+void testEnvironment_MultiValueVariableSet_ShouldSplitValue()
+{
+    setenv("ARGENGINE_TEST_SIZE", " 640 \t480 ", 1);
+    Argengine ae({ "test" });
+    std::vector<std::string> size;
+    ae.addOption({ "--size" }, Argengine::Arity::exactly(2), [&](Argengine::StringViewSpan values) {
+        size = { values.begin(), values.end() };
+    });
+    ae.bindEnvironmentVariable("--size", "ARGENGINE_TEST_SIZE");
+    ae.parse();
+    assert(size == std::vector<std::string>({ "640", "480" }));
+    unsetenv("ARGENGINE_TEST_SIZE");
+}
+
+void testEnvironment_MultiValueVariableWithTooFewValues_ShouldFail()
+{
+    setenv("ARGENGINE_TEST_SIZE", "640", 1);
+    Argengine ae({ "test" });
+    bool called {};
+    ae.addOption({ "--size" }, Argengine::Arity::exactly(2), [&](Argengine::StringViewSpan) {
+        called = true;
+    });
+    ae.bindEnvironmentVariable("--size", "ARGENGINE_TEST_SIZE");
+    Argengine::Error error;
+    ae.parse(error);
+    assert(!called);
+    assert(error.code == Argengine::Error::Code::MissingValue);
+
+    setenv("ARGENGINE_TEST_SIZE", "640 480 32", 1);
+    ae.parse(error);
+    assert(!called);
+    assert(error.code == Argengine::Error::Code::InvalidValue);
+    unsetenv("ARGENGINE_TEST_SIZE");
+}
+
+int main(int, char **)
+{
+    testEnvironment_VariableSet_ShouldUseValue();
+
+    testEnvironment_OptionGiven_ShouldTakePrecedence();
+
+    testEnvironment_RequiredFromVariable_ShouldSucceed();
+
+    testEnvironment_ConflictWithArgument_ShouldFail();
+
+    testEnvironment_UnknownOption_ShouldThrow();
+
+    testEnvironment_CompiledSchema_ShouldUseVariable();
+
+    testEnvironment_MultiValueVariableSet_ShouldSplitValue();
+
+    testEnvironment_MultiValueVariableWithTooFewValues_ShouldFail();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,258 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <array>
+#include <cassert>
+#include <cstdlib>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testErrorCode_ValidArguments_ShouldReturnOk()
+{
+    Argengine ae({ "test", "-f", "1" });
+    bool called {};
+    ae.addOption({ "-f" }, [&](std::string_view) {
+        called = true;
+    });
+    assert(ae.tryParse() == Argengine::Error::Code::Ok);
+    assert(ae.errorMessage().empty());
+    assert(called);
+}
+
+void testErrorCode_UnknownOption_ShouldReturnUnknownOption()
+{
+    Argengine ae({ "test", "-x" });
+    bool called {};
+    ae.addOption({ "-a" }, [&] {
+        called = true;
+    });
+    assert(ae.tryParse() == Argengine::Error::Code::UnknownOption);
+    assert(ae.errorMessage() == std::string(name) + ": Unknown option '-x'!");
+    assert(!called);
+}
+
+void testErrorCode_NoValue_ShouldReturnMissingValue()
+{
+    Argengine ae({ "test", "-f" });
+    ae.addOption({ "-f" }, [](std::string_view) {
+    });
+    assert(ae.tryParse() == Argengine::Error::Code::MissingValue);
+    assert(ae.errorMessage() == std::string(name) + ": No value for option '-f' given!");
+}
+
+void testErrorCode_TooFewValues_ShouldReturnMissingValue()
+{
+    Argengine ae({ "test", "--size", "640" });
+    ae.addOption({ "--size" }, Argengine::Arity::exactly(2), [](Argengine::StringViewSpan) {
+    });
+    assert(ae.tryParse() == Argengine::Error::Code::MissingValue);
+    assert(ae.errorMessage() == std::string(name) + ": Too few values for option '--size' given! Expected 2.");
+}
+
+void testErrorCode_InvalidValue_ShouldReturnInvalidValue()
+{
+    Argengine ae({ "test", "-n", "abc" });
+    ae.addOption<int64_t>({ "-n" }, [](int64_t) {
+    });
+    assert(ae.tryParse() == Argengine::Error::Code::InvalidValue);
+    assert(ae.errorMessage() == std::string(name) + ": Invalid value 'abc' for option '-n'!");
+}
+
+void testErrorCode_OutOfRange_ShouldReturnOutOfRange()
+{
+    Argengine ae({ "test", "-j", "0" });
+    ae.addOption<int64_t>(
+      { "-j" }, [](int64_t) {
+      },
+      { 1, 64 });
+    assert(ae.tryParse() == Argengine::Error::Code::OutOfRange);
+    assert(ae.errorMessage() == std::string(name) + ": Value '0' for option '-j' is out of range [1, 64]!");
+}
+
+void testErrorCode_Conflict_ShouldReturnConflict()
+{
+    Argengine ae({ "test", "-a", "-b" });
+    ae.addOption({ "-a" }, [] {
+    });
+    ae.addOption({ "-b" }, [] {
+    });
+    ae.addConflictingOptions({ "-a", "-b" });
+    assert(ae.tryParse() == Argengine::Error::Code::Conflict);
+    assert(ae.errorMessage() == std::string(name) + ": Conflicting options: '-a', '-b'. These options cannot coexist.");
+}
+
+void testErrorCode_GroupIncomplete_ShouldReturnGroupIncomplete()
+{
+    Argengine ae({ "test", "-a" });
+    ae.addOption({ "-a" }, [] {
+    });
+    ae.addOption({ "-b" }, [] {
+    });
+    ae.addOptionGroup({ "-a", "-b" });
+    assert(ae.tryParse() == Argengine::Error::Code::GroupIncomplete);
+    assert(ae.errorMessage() == std::string(name) + ": These options must coexist: '-a', '-b'. Missing options: '-b'.");
+}
+
+void testErrorCode_RequiredNotGiven_ShouldReturnRequired()
+{
+    Argengine ae({ "test" });
+    ae.addOption(
+      { "-f", "--foo" }, [](std::string_view) {
+      },
+      true);
+    assert(ae.tryParse() == Argengine::Error::Code::Required);
+    assert(ae.errorMessage() == std::string(name) + ": Option '-f, --foo' is required!");
+}
+
+void testErrorCode_ConfigFileMissing_ShouldReturnFailed()
+{
+    Argengine ae({ "test" });
+    ae.setConfigFile("argengine_no_such_file.ini");
+    assert(ae.tryParse() == Argengine::Error::Code::Failed);
+    assert(ae.errorMessage() == std::string(name) + ": Config file 'argengine_no_such_file.ini' cannot be read!");
+}
+
+void testErrorCode_EmptyArguments_ShouldReturnFailed()
+{
+    Argengine ae({ "test" });
+    assert(ae.tryParse({}) == Argengine::Error::Code::Failed);
+    assert(ae.errorMessage() == std::string(name) + ": Argument vector is empty!");
+}
+
+void testErrorCode_ReparseAfterError_ShouldReset()
+{
+    Argengine ae({ "test" });
+    size_t calls {};
+    ae.addOption({ "-a" }, [&] {
+        calls++;
+    });
+    Argengine::CommandLine commandLine;
+    commandLine.split("test -x");
+    assert(ae.tryParse(commandLine.arguments()) == Argengine::Error::Code::UnknownOption);
+    commandLine.split("test -a");
+    assert(ae.tryParse(commandLine.arguments()) == Argengine::Error::Code::Ok);
+    assert(ae.errorMessage().empty());
+    assert(calls == 1);
+}
+
+void testErrorCode_ParseWithError_ShouldSetCodeAndMessage()
+{
+    Argengine ae({ "test", "-a" });
+    ae.addOption({ "-a" }, [] {
+    });
+    ae.addOption(
+      { "-f" }, [](std::string_view) {
+      },
+      true);
+    Argengine::Error error;
+    ae.parse(error);
+    assert(error.code == Argengine::Error::Code::Required);
+    assert(error.failed());
+    assert(error.message == std::string(name) + ": Option '-f' is required!");
+
+    ae.parse(Argengine::ArgumentVector { "test", "-f", "1" }, error);
+    assert(!error.failed());
+}
+
+void testErrorCode_SubcommandFails_ShouldReturnCodeOfSubcommand()
+{
+    Argengine ae({ "test", "run", "-x" });
+    ae.addSubcommand("run", [](Argengine &) {
+    });
+    assert(ae.tryParse() == Argengine::Error::Code::UnknownOption);
+    assert(ae.errorMessage() == std::string(name) + ": Unknown option '-x'!");
+}
+
+constexpr std::array<Argengine::StaticOption, 2> options = { {
+  { { "-a" } },
+  { { "-f" }, true, true },
+} };
+
+constexpr Argengine::Static<options.size()> schema { options };
+
+void testErrorCode_StaticSchema_ShouldReturnSpecificCodes()
+{
+    char arg0[] = "test", arg1[] = "-x", arg2[] = "-f";
+    const auto codeOf = [](int argc, char ** argv) {
+        Argengine::Error error;
+        schema.parse(
+          argc, argv, [](size_t, std::string_view) {
+          },
+          error);
+        return error.code;
+    };
+
+    char * unknown[] = { arg0, arg1 };
+    assert(codeOf(2, unknown) == Argengine::Error::Code::UnknownOption);
+
+    char * missingValue[] = { arg0, arg2 };
+    assert(codeOf(2, missingValue) == Argengine::Error::Code::MissingValue);
+
+    char * required[] = { arg0 };
+    assert(codeOf(1, required) == Argengine::Error::Code::Required);
+}
+
+int main(int, char **)
+{
+    testErrorCode_ValidArguments_ShouldReturnOk();
+
+    testErrorCode_UnknownOption_ShouldReturnUnknownOption();
+
+    testErrorCode_NoValue_ShouldReturnMissingValue();
+
+    testErrorCode_TooFewValues_ShouldReturnMissingValue();
+
+    testErrorCode_InvalidValue_ShouldReturnInvalidValue();
+
+    testErrorCode_OutOfRange_ShouldReturnOutOfRange();
+
+    testErrorCode_Conflict_ShouldReturnConflict();
+
+    testErrorCode_GroupIncomplete_ShouldReturnGroupIncomplete();
+
+    testErrorCode_RequiredNotGiven_ShouldReturnRequired();
+
+    testErrorCode_ConfigFileMissing_ShouldReturnFailed();
+
+    testErrorCode_EmptyArguments_ShouldReturnFailed();
+
+    testErrorCode_ReparseAfterError_ShouldReset();
+
+    testErrorCode_ParseWithError_ShouldSetCodeAndMessage();
+
+    testErrorCode_SubcommandFails_ShouldReturnCodeOfSubcommand();
+
+    testErrorCode_StaticSchema_ShouldReturnSpecificCodes();
+
+    return EXIT_SUCCESS;
+}
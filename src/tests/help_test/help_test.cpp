@@ -102,6 +102,211 @@ void testDefaultHelp_SingleValueOptionAdded_ShouldSucceed()
     assert(ss.str() == answer);
 }
 
+void testDefaultHelp_OptionAddedAfterPrint_ShouldUpdate()
+{
+    Argengine ae({ "test" });
+    std::stringstream ss;
+    ae.setOutputStream(ss);
+    ae.printHelp();
+    ae.addOption(
+      { "-f", "--foo" }, [](std::string) {}, false, "Add foo.", "FOO");
+    ae.setHelpText("Foo");
+    ss.str("");
+    ae.printHelp();
+    const std::string answer = "Foo\n\n"
+                               "Options:\n\n"
+                               "-h, --help       Show this help.\n"
+                               "-f, --foo [FOO]  Add foo.\n\n";
+    assert(ss.str() == answer);
+}
+
+void testDefaultHelp_SortingChangedAfterPrint_ShouldUpdate()
+{
+    Argengine ae({ "test" });
+    ae.addOption(
+      { "-a" }, [] {}, false, "Add a.");
+    std::stringstream ss;
+    ae.setOutputStream(ss);
+    ae.setHelpText("");
+    ae.printHelp();
+    ae.setHelpSorting(Argengine::HelpSorting::Ascending);
+    ss.str("");
+    ae.printHelp();
+    const std::string answer = "Options:\n\n"
+                               "-a          Add a.\n"
+                               "-h, --help  Show this help.\n\n";
+    assert(ss.str() == answer);
+}
+
+void addFilteredHelpOptions(Argengine & ae, std::stringstream & ss)
+{
+    ae.setOutputStream(ss);
+    ae.setHelpSection("Logging");
+    ae.addOption(
+      { "--log-level" }, [](std::string) {}, false, "Set log level.", "LEVEL");
+    ae.addOption(
+      { "--log-file" }, [](std::string) {}, false, "Set log file.", "FILE");
+    ae.setHelpSection("");
+    ae.addOption(
+      { "-o", "--output" }, [](std::string) {}, false, "Set output.", "FILE");
+}
+
+void testFilteredHelp_ExactVariant_ShouldPrintOnlyOption()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    addFilteredHelpOptions(ae, ss);
+    ae.printHelp("-o");
+    const std::string answer = "Options matching '-o':\n\n"
+                               "-o, --output [FILE]  Set output.\n\n";
+    assert(ss.str() == answer);
+}
+
+void testFilteredHelp_Section_ShouldPrintSection()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    addFilteredHelpOptions(ae, ss);
+    ae.printHelp("Logging");
+    const std::string answer = "Options matching 'Logging':\n\n"
+                               "--log-level [LEVEL]  Set log level.\n"
+                               "--log-file [FILE]    Set log file.\n\n";
+    assert(ss.str() == answer);
+}
+
+void testFilteredHelp_Glob_ShouldPrintMatchingOptions()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    addFilteredHelpOptions(ae, ss);
+    ae.printHelp("--*-f?le");
+    const std::string answer = "Options matching '--*-f?le':\n\n"
+                               "--log-file [FILE]    Set log file.\n\n";
+    assert(ss.str() == answer);
+}
+
+void testFilteredHelp_Substring_ShouldPrintMatchingOptions()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    addFilteredHelpOptions(ae, ss);
+    ae.printHelp("put");
+    const std::string answer = "Options matching 'put':\n\n"
+                               "-o, --output [FILE]  Set output.\n\n";
+    assert(ss.str() == answer);
+}
+
+void testFilteredHelp_NoMatch_ShouldPrintNotice()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    addFilteredHelpOptions(ae, ss);
+    ae.printHelp("--foo");
+    assert(ss.str() == "No options matching '--foo'.\n");
+}
+
+void testFilteredHelp_EmptyFilter_ShouldPrintFullHelp()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    addFilteredHelpOptions(ae, ss);
+    ae.printHelp("");
+    std::stringstream full;
+    Argengine fullAe({ "test" });
+    addFilteredHelpOptions(fullAe, full);
+    fullAe.printHelp();
+    assert(ss.str() == full.str());
+}
+
+void configureIncrementalHelp(Argengine & ae, std::stringstream & ss, bool printBetween)
+{
+    ae.setOutputStream(ss);
+    ae.setHelpSorting(Argengine::HelpSorting::Ascending);
+    ae.addOption(
+      { "--output" }, [](std::string) {}, false, "Set output.", "FILE");
+    if (printBetween) {
+        ae.printHelp();
+    }
+    ae.addOption(
+      { "-b" }, [] {}, false, "Add b.");
+    ae.addSubcommand("build", [](Argengine &) {
+    });
+    if (printBetween) {
+        ae.printHelp();
+    }
+    ae.setHelpText("Foo");
+    ae.addOption(
+      { "-a" }, [] {}, false, "Add a.");
+    ae.addSubcommand(
+      "run", [](Argengine &) {
+      },
+      "Run.");
+    if (printBetween) {
+        ae.printHelp("-b");
+    }
+    ae.addOption(
+      { "--very-long-option" }, [] {}, false, "Widen the column.");
+    ae.addSubcommand("deploy", [](Argengine &) {
+    });
+}
+
+void testDefaultHelp_ChangedAfterPrint_ShouldMatchFreshHelp()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    configureIncrementalHelp(ae, ss, true);
+    ss.str("");
+    ae.printHelp();
+    std::stringstream fresh;
+    Argengine freshAe({ "test" });
+    configureIncrementalHelp(freshAe, fresh, false);
+    freshAe.printHelp();
+    assert(ss.str() == fresh.str());
+    const std::string answer = "Foo\n\n"
+                               "Options:\n\n"
+                               "--output [FILE]     Set output.\n"
+                               "--very-long-option  Widen the column.\n"
+                               "-a                  Add a.\n"
+                               "-b                  Add b.\n"
+                               "-h, --help          Show this help.\n\n"
+                               "Commands:\n\n"
+                               "build               \n"
+                               "run                 Run.\n"
+                               "deploy              \n\n";
+    assert(ss.str() == answer);
+}
+
+void testDefaultHelp_OptionAddedAfterPrint_ShouldInsertLine()
+{
+    std::stringstream ss;
+    Argengine ae({ "test" });
+    configureIncrementalHelp(ae, ss, false);
+    ae.printHelp();
+    ae.addOption(
+      { "-c" }, [] {}, false, "Add c.");
+    ae.addSubcommand("test", [](Argengine &) {
+    });
+    ae.setHelpText("");
+    ss.str("");
+    ae.printHelp();
+    const std::string answer = "Options:\n\n"
+                               "--output [FILE]     Set output.\n"
+                               "--very-long-option  Widen the column.\n"
+                               "-a                  Add a.\n"
+                               "-b                  Add b.\n"
+                               "-c                  Add c.\n"
+                               "-h, --help          Show this help.\n\n"
+                               "Commands:\n\n"
+                               "build               \n"
+                               "run                 Run.\n"
+                               "deploy              \n"
+                               "test                \n\n";
+    assert(ss.str() == answer);
+    ss.str("");
+    ae.printHelp("-c");
+    assert(ss.str() == "Options matching '-c':\n\n-c                  Add c.\n\n");
+}
+
 void testSetGetHelpText_ShouldSucceed()
 {
     Argengine ae({ "test" });
@@ -122,6 +327,26 @@ int main(int, char **)
 
     testDefaultHelp_SingleValueOptionAdded_ShouldSucceed();
 
+    testDefaultHelp_OptionAddedAfterPrint_ShouldUpdate();
+
+    testDefaultHelp_SortingChangedAfterPrint_ShouldUpdate();
+
+    testFilteredHelp_ExactVariant_ShouldPrintOnlyOption();
+
+    testFilteredHelp_Section_ShouldPrintSection();
+
+    testFilteredHelp_Glob_ShouldPrintMatchingOptions();
+
+    testFilteredHelp_Substring_ShouldPrintMatchingOptions();
+
+    testFilteredHelp_NoMatch_ShouldPrintNotice();
+
+    testFilteredHelp_EmptyFilter_ShouldPrintFullHelp();
+
+    testDefaultHelp_ChangedAfterPrint_ShouldMatchFreshHelp();
+
+    testDefaultHelp_OptionAddedAfterPrint_ShouldInsertLine();
+
     testSetGetHelpText_ShouldSucceed();
 
     return EXIT_SUCCESS;
@@ -0,0 +1,251 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "../../argengine.hpp"
+#include "../test_file.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+namespace {
+size_t globalAllocations = 0;
+}
+
+void * operator new(size_t size)
+{
+    globalAllocations++;
+    if (const auto ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+class TestResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+
+    size_t bytesInUse = 0;
+
+private:
+    void * do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        bytesInUse += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void * ptr, size_t bytes, size_t alignment) override
+    {
+        bytesInUse -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+void testMemoryResource_AddOption_ShouldAllocateFromResource()
+{
+    TestResource resource;
+    Argengine ae({ "test", "-a", "1" }, true, &resource);
+    const auto allocations = resource.allocations;
+    assert(allocations > 0);
+    ae.addOption({ "-a", "--aaa" }, [](std::string_view) {
+    });
+    assert(resource.allocations > allocations);
+}
+
+void testMemoryResource_Parse_ShouldAllocateFromResource()
+{
+    TestResource resource;
+    Argengine ae({ "test", "-a", "1", "foo" }, true, &resource);
+    std::string a;
+    ae.addOption({ "-a" }, [&](std::string_view value) {
+        a = value;
+    });
+    ae.setPositionalArgumentCallback([](Argengine::StringViewSpan) {
+    });
+    const auto allocations = resource.allocations;
+    ae.parse();
+    assert(a == "1");
+    assert(resource.allocations > allocations);
+}
+
+void testMemoryResource_Destroyed_ShouldReleaseEverything()
+{
+    TestResource resource;
+    {
+        Argengine ae({ "test", "-a", "1" }, true, &resource);
+        ae.addOption({ "-a" }, [](std::string_view) {
+        });
+        ae.addConflictingOptions({ "-a", "-h" });
+        ae.parse();
+        ae.parse();
+    }
+    assert(resource.bytesInUse == 0);
+}
+
+void testMemoryResource_DetachedFromSchema_ShouldCopyToResource()
+{
+    TestResource resource;
+    Argengine ae({ "test" });
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    const auto schema = ae.compile();
+    {
+        Argengine instance(schema, { "test", "-b", "2" }, &resource);
+        const auto allocations = resource.allocations;
+        std::string b;
+        instance.addOption({ "-b" }, [&](std::string_view value) {
+            b = value;
+        });
+        assert(resource.allocations > allocations);
+        instance.parse();
+        assert(b == "2");
+    }
+    assert(resource.bytesInUse == 0);
+}
+
+void testMemoryResource_HelpTextOfSharedSchema_ShouldNotCopySchema()
+{
+    TestResource resource;
+    Argengine ae({ "test" });
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    const auto schema = ae.compile();
+    const Argengine instance(schema, { "test" }, &resource);
+    const auto allocations = resource.allocations;
+    assert(instance.helpText() == ae.helpText());
+    assert(resource.allocations == allocations);
+}
+
+void testMemoryResource_OptionsAndParses_ShouldNotAllocateFromGlobalHeap()
+{
+    // The resource takes its memory from a buffer, so that any global allocation is made by the parser
+    static std::array<std::byte, 1 << 20> buffer;
+    std::pmr::monotonic_buffer_resource resource { buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+
+    // The variants and the arguments are the caller's allocations, so they are made beforehand
+    constexpr size_t optionCount = 100;
+    std::vector<Argengine::OptionSet> variants;
+    std::vector<std::string> infoTexts;
+    std::vector<std::string> args { "test" };
+    for (size_t i = 0; i < optionCount; i++) {
+        const auto name = "--option-with-a-long-name-" + std::to_string(i);
+        variants.push_back({ "-o" + std::to_string(i), name });
+        infoTexts.push_back("Option " + std::to_string(i) + " with a long info text.");
+        args.push_back(name);
+        if (i % 2) {
+            args.push_back("value-that-is-not-short-" + std::to_string(i));
+        }
+    }
+    Argengine::OptionSet conflicting { "-o0", "--none" };
+    Argengine::OptionSet group { "-o1", "-o2" };
+    auto configFile = writeFile("argengine_memory_resource_test.conf", "option-with-a-long-name-0 = true\n");
+    args.insert(args.end(), { "positional-argument", "@" + writeFile("argengine_memory_resource_test.rsp", "response-file-argument"), "build", "subcommand-argument" });
+    std::vector<char *> argv;
+    for (auto && arg : args) {
+        argv.push_back(arg.data());
+    }
+
+    size_t given = 0;
+    const auto allocations = globalAllocations;
+    {
+        Argengine ae(static_cast<int>(argv.size()), argv.data(), Argengine::ArgumentStorage::View, true, &resource);
+        for (size_t i = 0; i < optionCount; i++) {
+            if (i % 2) {
+                ae.addOption(
+                  std::move(variants.at(i)), [&given](std::string_view) {
+                      given++;
+                  },
+                  false, std::move(infoTexts.at(i)));
+            } else {
+                ae.addOption(
+                  std::move(variants.at(i)), [&given] {
+                      given++;
+                  },
+                  false, std::move(infoTexts.at(i)));
+            }
+        }
+        ae.setResponseFileExpansion(true);
+        ae.setConfigFile(std::move(configFile));
+        ae.addConflictingOptions(std::move(conflicting));
+        ae.addOptionGroup(std::move(group));
+        ae.setPositionalArgumentCallback([&given](Argengine::StringViewSpan positionalArguments) {
+            given += positionalArguments.size();
+        });
+        ae.addSubcommand("build", [&given](Argengine & subcommand) {
+            subcommand.setPositionalArgumentCallback([&given](Argengine::StringViewSpan positionalArguments) {
+                given += positionalArguments.size();
+            });
+        });
+        ae.parse();
+        ae.parse();
+    }
+    assert(globalAllocations == allocations);
+    assert(given == 2 * (optionCount + 3));
+}
+
+int main(int, char **)
+{
+    testMemoryResource_AddOption_ShouldAllocateFromResource();
+
+    testMemoryResource_Parse_ShouldAllocateFromResource();
+
+    testMemoryResource_Destroyed_ShouldReleaseEverything();
+
+    testMemoryResource_DetachedFromSchema_ShouldCopyToResource();
+
+    testMemoryResource_HelpTextOfSharedSchema_ShouldNotCopySchema();
+
+    testMemoryResource_OptionsAndParses_ShouldNotAllocateFromGlobalHeap();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+using ValueVector = std::vector<std::string>;
+
+ValueVector toVector(Argengine::StringViewSpan values)
+{
+    return { values.begin(), values.end() };
+}
+
+void testMultiValue_ExactlyGiven_ShouldSucceed()
+{
+    Argengine ae({ "test", "--size", "640", "480", "foo" });
+    ValueVector size;
+    ae.addOption({ "--size" }, Argengine::Arity::exactly(2), [&](Argengine::StringViewSpan values) {
+        size = toVector(values);
+    });
+    ValueVector positional;
+    ae.setPositionalArgumentCallback([&](Argengine::ArgumentVector arguments) {
+        positional = arguments;
+    });
+    ae.parse();
+    assert(size == ValueVector({ "640", "480" }));
+    assert(positional == ValueVector({ "foo" }));
+}
+
+void testMultiValue_UntilNextOption_ShouldSucceed()
+{
+    Argengine ae({ "test", "--ids", "1", "2", "3", "-v", "--ids=4", "5" });
+    size_t calls {};
+    ValueVector ids;
+    ae.addOption({ "--ids" }, Argengine::Arity::atLeast(1), [&](Argengine::StringViewSpan values) {
+        calls++;
+        ids = toVector(values);
+    });
+    bool verbose {};
+    ae.addOption({ "-v" }, [&] {
+        verbose = true;
+    });
+    ae.parse();
+    assert(calls == 1);
+    assert(ids == ValueVector({ "1", "2", "3", "4", "5" }));
+    assert(verbose);
+}
+
+void testMultiValue_Repeated_ShouldAccumulateIntoSingleCall()
+{
+    Argengine ae({ "test", "-I", "a", "-D", "X", "-Ib", "-I", "c" });
+    size_t calls {};
+    ValueVector includes;
+    ae.addOption({ "-I" }, Argengine::Arity::exactly(1), [&](Argengine::StringViewSpan values) {
+        calls++;
+        includes = toVector(values);
+    });
+    ValueVector defines;
+    ae.addOption({ "-D" }, Argengine::Arity::exactly(1), [&](Argengine::StringViewSpan values) {
+        defines = toVector(values);
+    });
+    ae.parse();
+    assert(calls == 1);
+    assert(includes == ValueVector({ "a", "b", "c" }));
+    assert(defines == ValueVector({ "X" }));
+}
+
+void testMultiValue_AnyWithoutValues_ShouldSucceed()
+{
+    Argengine ae({ "test", "--tags", "-v" });
+    bool called {};
+    ae.addOption({ "--tags" }, Argengine::Arity::any(), [&](Argengine::StringViewSpan values) {
+        called = values.empty();
+    });
+    ae.addOption({ "-v" }, [] {
+    });
+    ae.parse();
+    assert(called);
+}
+
+void testMultiValue_TooFewValues_ShouldFail()
+{
+    Argengine ae({ "test", "--size", "640", "-v" });
+    bool called {};
+    ae.addOption({ "--size" }, Argengine::Arity::exactly(2), [&](Argengine::StringViewSpan) {
+        called = true;
+    });
+    ae.addOption({ "-v" }, [&] {
+        called = true;
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(!called);
+    assert(error == std::string(name) + ": Too few values for option '--size' given! Expected 2.");
+}
+
+void testMultiValue_Help_ShouldShowValueList()
+{
+    Argengine ae({ "test" });
+    ae.addOption(
+      { "--ids" }, Argengine::Arity::atLeast(1), [](Argengine::StringViewSpan) {
+      },
+      false, "Ids to process.", "ID");
+    std::stringstream out;
+    ae.setOutputStream(out);
+    ae.printHelp();
+    assert(out.str().find("--ids [ID...]  Ids to process.") != std::string::npos);
+}
+
+int main(int, char **)
+{
+    testMultiValue_ExactlyGiven_ShouldSucceed();
+
+    testMultiValue_UntilNextOption_ShouldSucceed();
+
+    testMultiValue_Repeated_ShouldAccumulateIntoSingleCall();
+
+    testMultiValue_AnyWithoutValues_ShouldSucceed();
+
+    testMultiValue_TooFewValues_ShouldFail();
+
+    testMultiValue_Help_ShouldShowValueList();
+
+    return EXIT_SUCCESS;
+}
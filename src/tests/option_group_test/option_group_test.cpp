@@ -115,6 +115,37 @@ void testOptionGroup_optionMissing_shouldNotReferToVariants_shouldFail()
     assert(error == std::string(name) + ": These options must coexist: '" + a2 + "', '" + a3 + "'. Missing options: '" + a2 + "'.");
 }
 
+void testOptionGroup_unknownOptionInGroup_shouldFail()
+{
+    Argengine ae({ "a1", "a2" });
+    ae.addOption({ "a2" }, [] {
+    });
+    ae.addOptionGroup({ "a2", "a4" });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": These options must coexist: 'a2', 'a4'. Missing options: 'a4'.");
+}
+
+void testOptionGroup_noneGiven_shouldSucceed()
+{
+    Argengine ae({ "a1", "a4" });
+    ae.addOption({ "a2" }, [] {
+    });
+    ae.addOption({ "a3" }, [] {
+    });
+    bool a4Called {};
+    ae.addOption({ "a4" }, [&] {
+        a4Called = true;
+    });
+    ae.addOptionGroup({ "a2", "a3" });
+    ae.parse();
+    assert(a4Called);
+}
+
 int main(int, char **)
 {
     testOptionGroup_optionsExist_shouldSucceed();
@@ -123,5 +154,9 @@ int main(int, char **)
 
     testOptionGroup_optionMissing_shouldNotReferToVariants_shouldFail();
 
+    testOptionGroup_unknownOptionInGroup_shouldFail();
+
+    testOptionGroup_noneGiven_shouldSucceed();
+
     return EXIT_SUCCESS;
 }
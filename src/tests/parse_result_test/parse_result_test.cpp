@@ -0,0 +1,208 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+std::vector<std::string> toVector(Argengine::StringViewSpan values)
+{
+    return { values.begin(), values.end() };
+}
+
+void testParseResult_OptionsAndPositionalArguments_ShouldSucceed()
+{
+    Argengine ae({ "test", "-a", "--foo=1", "x", "-f2", "--all", "y" });
+    bool called {};
+    ae.addOption({ "-a", "--all" }, [&] {
+        called = true;
+    });
+    ae.addOption({ "-f", "--foo" }, [&](std::string) {
+        called = true;
+    });
+    ae.addOption({ "-b" }, [&] {
+        called = true;
+    });
+    ae.setPositionalArgumentCallback([&](Argengine::StringViewSpan) {
+        called = true;
+    });
+    const auto result = ae.parseResult();
+    assert(!called);
+    assert(result.has("-a"));
+    assert(result.has("--all"));
+    assert(result.count("-a") == 2);
+    assert(result.value("-a").empty());
+    assert(result.has("--foo"));
+    assert(result.count("-f") == 2);
+    assert(result.value("-f") == "2");
+    assert(toVector(result.values("--foo")) == std::vector<std::string>({ "1", "2" }));
+    assert(!result.has("-b"));
+    assert(result.count("-b") == 0);
+    assert(result.values("-b").empty());
+    assert(!result.has("--unknown"));
+    assert(toVector(result.positionalArguments()) == std::vector<std::string>({ "x", "y" }));
+    assert(result.subcommand().empty());
+}
+
+void testParseResult_MultiValueOption_ShouldReturnAllValues()
+{
+    Argengine ae({ "test", "-i", "a", "b", "-v", "-i", "c" });
+    ae.addOption({ "-i" }, Argengine::Arity::atLeast(1), [](Argengine::StringViewSpan) {
+    });
+    ae.addOption({ "-v" }, [] {
+    });
+    const auto result = ae.parseResult();
+    assert(result.count("-i") == 2);
+    assert(toVector(result.values("-i")) == std::vector<std::string>({ "a", "b", "c" }));
+    assert(result.value("-i") == "c");
+    assert(result.has("-v"));
+}
+
+void testParseResult_ManyOptions_ShouldFindEachOption()
+{
+    Argengine::ArgumentVector args { "test" };
+    for (size_t i = 0; i < 200; i += 3) {
+        args.push_back("--o" + std::to_string(i) + "=" + std::to_string(i * 2));
+    }
+    Argengine ae(args);
+    for (size_t i = 0; i < 200; i++) {
+        ae.addOption({ "--o" + std::to_string(i) }, [](std::string_view) {
+        });
+    }
+    const auto result = ae.parseResult();
+    for (size_t i = 0; i < 200; i++) {
+        const auto option = "--o" + std::to_string(i);
+        assert(result.has(option) == !(i % 3));
+        assert(result.value(option) == (i % 3 ? "" : std::to_string(i * 2)));
+    }
+}
+
+void testParseResult_Error_ShouldReturnEmptyResult()
+{
+    Argengine ae({ "test", "-a" });
+    ae.addOption({ "-a" }, [] {
+    });
+    ae.addOption(
+      { "-f" }, [](std::string) {
+      },
+      true);
+    Argengine::Error error;
+    const auto result = ae.parseResult(error);
+    assert(error.code == Argengine::Error::Code::Required);
+    assert(error.message == std::string(name) + ": Option '-f' is required!");
+    assert(!result.has("-a"));
+    assert(result.positionalArguments().empty());
+}
+
+void testParseResult_Help_ShouldNotExit()
+{
+    Argengine ae({ "test", "--help" });
+    const auto result = ae.parseResult();
+    assert(result.has("-h"));
+}
+
+void testParseResult_Subcommand_ShouldNotCallFactory()
+{
+    Argengine ae({ "test", "-v", "build", "--release" });
+    bool called {};
+    ae.addOption({ "-v" }, [] {
+    });
+    ae.addSubcommand("build", [&](Argengine &) {
+        called = true;
+    });
+    const auto result = ae.parseResult();
+    assert(!called);
+    assert(result.has("-v"));
+    assert(result.subcommand() == "build");
+    assert(toVector(result.subcommandArguments()) == std::vector<std::string>({ "build", "--release" }));
+}
+
+void testParseResult_GivenArguments_ShouldOutliveNextParse()
+{
+    const auto path = (std::filesystem::temp_directory_path() / "argengine_pr_1.txt").string();
+    std::ofstream { path, std::ios::binary } << "-f 'from file'";
+    Argengine ae({ "shell" });
+    ae.addOption({ "-f" }, [](std::string_view) {
+    });
+    ae.setResponseFileExpansion(true);
+    Argengine::CommandLine first;
+    assert(first.split("cmd @" + path));
+    const auto firstResult = ae.parseResult(first.arguments());
+    Argengine::CommandLine second;
+    assert(second.split("cmd -f second"));
+    const auto secondResult = ae.parseResult(second.arguments());
+    std::filesystem::remove(path);
+    assert(firstResult.value("-f") == "from file");
+    assert(secondResult.value("-f") == "second");
+}
+
+void testParseResult_OptionAddedAfterParse_ShouldNotAffectResult()
+{
+    Argengine ae({ "test", "-a" });
+    ae.addOption({ "-a" }, [] {
+    });
+    const auto result = ae.parseResult();
+    ae.addOption({ "-b" }, [] {
+    });
+    assert(result.has("-a"));
+    assert(!result.has("-b"));
+    Argengine::CommandLine commandLine;
+    assert(commandLine.split("test -b"));
+    assert(ae.parseResult(commandLine.arguments()).has("-b"));
+}
+
+int main(int, char **)
+{
+    testParseResult_OptionsAndPositionalArguments_ShouldSucceed();
+
+    testParseResult_MultiValueOption_ShouldReturnAllValues();
+
+    testParseResult_ManyOptions_ShouldFindEachOption();
+
+    testParseResult_Error_ShouldReturnEmptyResult();
+
+    testParseResult_Help_ShouldNotExit();
+
+    testParseResult_Subcommand_ShouldNotCallFactory();
+
+    testParseResult_GivenArguments_ShouldOutliveNextParse();
+
+    testParseResult_OptionAddedAfterParse_ShouldNotAffectResult();
+
+    return EXIT_SUCCESS;
+}
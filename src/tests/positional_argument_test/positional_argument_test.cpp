@@ -103,6 +103,99 @@ void testMultiplePositionalArguments_NoOtherArguments_ShouldSucceed()
     assert(ps.at(1) == ae.arguments().at(2));
 }
 
+void testMultiplePositionalArguments_StringViewCallback_ShouldSucceed()
+{
+    Argengine ae({ "test", "a", "--foo", "42" });
+    ae.addOption({ "--foo" }, [] {
+    });
+    Argengine::ArgumentVector ps;
+    ae.setPositionalArgumentCallback([&](Argengine::StringViewSpan args) {
+        for (auto && arg : args) {
+            ps.push_back(std::string { arg });
+        }
+    });
+    ae.parse();
+    assert(ps.size() == 2);
+    assert(ps.at(0) == ae.arguments().at(1));
+    assert(ps.at(1) == ae.arguments().at(3));
+}
+
+void testMultiplePositionalArguments_Batches_ShouldBeStreamedInOrder()
+{
+    Argengine ae({ "test", "a", "b", "c", "--foo", "d", "e" });
+    std::vector<std::string> events;
+    ae.addOption({ "--foo" }, [&] {
+        events.push_back("--foo");
+    });
+    ae.setPositionalArgumentCallback(
+      [&](Argengine::StringViewSpan args) {
+          std::string batch;
+          for (auto && arg : args) {
+              batch += arg;
+          }
+          events.push_back(batch);
+      },
+      2);
+    ae.parse();
+    assert(events == std::vector<std::string>({ "ab", "--foo", "cd", "e" }));
+}
+
+void testMultiplePositionalArguments_BatchesAndUnknownOption_ShouldFailBeforeBatches()
+{
+    Argengine ae({ "test", "a", "b", "--foo" });
+    bool called {};
+    ae.setPositionalArgumentCallback(
+      [&](Argengine::StringViewSpan) {
+          called = true;
+      },
+      1);
+    ae.addOption({ "--foo" }, [](std::string) {
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(!called);
+    assert(error == "Argengine: No value for option '--foo' given!");
+}
+
+void testPositionalArguments_EndOfOptions_ShouldTreatOptionsAsPositional()
+{
+    Argengine ae({ "test", "-a", "--", "-a", "--foo=1", "--", "x" });
+    size_t calls {};
+    Argengine::ArgumentVector ps;
+    ae.addOption({ "-a" }, [&] {
+        calls++;
+    });
+    ae.addOption({ "--foo" }, [&](std::string) {
+        calls++;
+    });
+    ae.setPositionalArgumentCallback([&](Argengine::ArgumentVector args) {
+        ps = args;
+    });
+    ae.parse();
+    assert(calls == 1);
+    assert(ps == Argengine::ArgumentVector({ "-a", "--foo=1", "--", "x" }));
+}
+
+void testPositionalArguments_EndOfOptionsAsValue_ShouldFail()
+{
+    Argengine ae({ "test", "--foo", "--", "x" });
+    ae.addOption({ "--foo" }, [](std::string) {
+    });
+    ae.setPositionalArgumentCallback([](Argengine::ArgumentVector) {
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == "Argengine: No value for option '--foo' given!");
+}
+
 int main(int, char **)
 {
     testSinglePositionalArgument_NoOtherArguments_ShouldSucceed();
@@ -115,5 +208,15 @@ int main(int, char **)
 
     testMultiplePositionalArguments_NoOtherArguments_ShouldSucceed();
 
+    testMultiplePositionalArguments_StringViewCallback_ShouldSucceed();
+
+    testMultiplePositionalArguments_Batches_ShouldBeStreamedInOrder();
+
+    testMultiplePositionalArguments_BatchesAndUnknownOption_ShouldFailBeforeBatches();
+
+    testPositionalArguments_EndOfOptions_ShouldTreatOptionsAsPositional();
+
+    testPositionalArguments_EndOfOptionsAsValue_ShouldFail();
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,149 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testReparse_RequiredGivenOnlyFirst_ShouldFailSecond()
+{
+    Argengine ae({ "test" });
+    size_t calls {};
+    ae.addOption(
+      { "-f", "--foo" }, [&](std::string) {
+          calls++;
+      },
+      true);
+    ae.parse({ "test", "-f", "1" });
+    assert(calls == 1);
+    Argengine::Error error;
+    ae.parse({ "test" }, error);
+    assert(error.code == Argengine::Error::Code::Required);
+    assert(error.message == std::string(name) + ": Option '-f, --foo' is required!");
+    assert(calls == 1);
+    error = {};
+    ae.parse({ "test", "--foo=2" }, error);
+    assert(error.code == Argengine::Error::Code::Ok);
+    assert(calls == 2);
+}
+
+void testReparse_CommandLines_ShouldParseEachCommand()
+{
+    Argengine ae({ "shell" });
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-a" }, [&] {
+        values["a"] = "called";
+    });
+    ae.addOption({ "-o" }, [&](std::string_view value) {
+        values["o"] = value;
+    });
+    Argengine::StringValueVector ps;
+    ae.setPositionalArgumentCallback([&](Argengine::StringValueVector args) {
+        ps = args;
+    });
+    Argengine::CommandLine commandLine;
+    assert(commandLine.split("cmd -a -o 'x y' file"));
+    ae.parse(commandLine.arguments());
+    assert(values["a"] == "called");
+    assert(values["o"] == "x y");
+    assert(ps == Argengine::StringValueVector({ "file" }));
+    values.clear();
+    assert(commandLine.split("cmd -o z"));
+    ae.parse(commandLine.arguments());
+    assert(!values.count("a"));
+    assert(values["o"] == "z");
+    assert(ae.stats().tokens == 2);
+    assert(ae.arguments() == Argengine::ArgumentVector({ "shell" }));
+}
+
+void testReparse_AfterError_ShouldSucceed()
+{
+    Argengine ae({ "test" });
+    bool called {};
+    ae.addOption({ "-a" }, [&] {
+        called = true;
+    });
+    Argengine::Error error;
+    ae.parse({ "test", "-x" }, error);
+    assert(error.message == std::string(name) + ": Unknown option '-x'!");
+    assert(!called);
+    ae.parse({ "test", "-a" });
+    assert(called);
+}
+
+void testReparse_MultiValues_ShouldNotAccumulate()
+{
+    Argengine ae({ "test" });
+    ae.addOption({ "-a" }, [] {
+    });
+    std::vector<std::string> files;
+    ae.addOption({ "-i" }, Argengine::Arity::any(), [&](Argengine::StringViewSpan values) {
+        files.assign(values.begin(), values.end());
+    });
+    ae.parse({ "test", "-i", "a", "b", "-a", "-i", "c" });
+    assert(files == std::vector<std::string>({ "a", "b", "c" }));
+    ae.parse({ "test", "-i", "d" });
+    assert(files == std::vector<std::string>({ "d" }));
+}
+
+void testReparse_EmptyArguments_ShouldFail()
+{
+    Argengine ae({ "test" });
+    std::string error;
+    try {
+        ae.parse(Argengine::StringViewSpan {});
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Argument vector is empty!");
+}
+
+int main(int, char **)
+{
+    testReparse_RequiredGivenOnlyFirst_ShouldFailSecond();
+
+    testReparse_CommandLines_ShouldParseEachCommand();
+
+    testReparse_AfterError_ShouldSucceed();
+
+    testReparse_MultiValues_ShouldNotAccumulate();
+
+    testReparse_EmptyArguments_ShouldFail();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+#include "../test_file.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testResponseFile_OptionsAndValues_ShouldSucceed()
+{
+    const auto path = writeFile("argengine_rf_1.txt", "-a\n-f 42 --bar=\"foo bar\"\n'x y' \"a\\\"b\" c\\ d");
+    Argengine ae({ "test", "-b", "@" + path, "last" });
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-a" }, [&] {
+        values["a"] = "called";
+    });
+    ae.addOption({ "-b" }, [&] {
+        values["b"] = "called";
+    });
+    ae.addOption({ "-f" }, [&](std::string value) {
+        values["f"] = value;
+    });
+    ae.addOption({ "--bar" }, [&](std::string_view value) {
+        values["bar"] = value;
+    });
+    Argengine::ArgumentVector ps;
+    ae.setPositionalArgumentCallback([&](Argengine::ArgumentVector args) {
+        ps = args;
+    });
+    ae.setResponseFileExpansion(true);
+    ae.parse();
+    assert(values["a"] == "called");
+    assert(values["b"] == "called");
+    assert(values["f"] == "42");
+    assert(values["bar"] == "foo bar");
+    assert(ps == Argengine::ArgumentVector({ "x y", "a\"b", "c d", "last" }));
+    std::filesystem::remove(path);
+}
+
+void testResponseFile_Nested_ShouldSucceed()
+{
+    const auto inner = writeFile("argengine_rf_inner.txt", "-f 42");
+    const auto outer = writeFile("argengine_rf_outer.txt", "-a @" + inner);
+    Argengine ae({ "test", "@" + outer });
+    bool a {};
+    ae.addOption({ "-a" }, [&] {
+        a = true;
+    });
+    std::string f;
+    ae.addOption({ "-f" }, [&](std::string value) {
+        f = value;
+    });
+    ae.setResponseFileExpansion(true);
+    ae.parse();
+    assert(a);
+    assert(f == "42");
+    std::filesystem::remove(inner);
+    std::filesystem::remove(outer);
+}
+
+void testResponseFile_Recursive_ShouldFail()
+{
+    const auto path = (std::filesystem::temp_directory_path() / "argengine_rf_recursive.txt").string();
+    writeFile("argengine_rf_recursive.txt", "-a @" + path);
+    Argengine ae({ "test", "@" + path });
+    ae.addOption({ "-a" }, [] {
+    });
+    ae.setResponseFileExpansion(true);
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Response file '" + path + "' is nested too deeply!");
+    std::filesystem::remove(path);
+}
+
+void testResponseFile_NotFound_ShouldFail()
+{
+    Argengine ae({ "test", "@/nonexistent/argengine_rf.txt" });
+    ae.setResponseFileExpansion(true);
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Response file '/nonexistent/argengine_rf.txt' cannot be read!");
+}
+
+void testResponseFile_NotEnabled_ShouldBePositional()
+{
+    Argengine ae({ "test", "@foo" });
+    Argengine::ArgumentVector ps;
+    ae.setPositionalArgumentCallback([&](Argengine::ArgumentVector args) {
+        ps = args;
+    });
+    ae.parse();
+    assert(ps == Argengine::ArgumentVector({ "@foo" }));
+}
+
+int main(int, char **)
+{
+    testResponseFile_OptionsAndValues_ShouldSucceed();
+
+    testResponseFile_Nested_ShouldSucceed();
+
+    testResponseFile_Recursive_ShouldFail();
+
+    testResponseFile_NotFound_ShouldFail();
+
+    testResponseFile_NotEnabled_ShouldBePositional();
+
+    return EXIT_SUCCESS;
+}
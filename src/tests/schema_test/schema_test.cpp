@@ -0,0 +1,159 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testCompiledSchema_MultipleParses_ShouldSucceed()
+{
+    Argengine configuration({ "test" });
+    std::string f;
+    configuration.addOption({ "-f", "--foo" }, [&](std::string value) {
+        f = value;
+    });
+    const auto schema = configuration.compile();
+
+    Argengine ae1(schema, { "test", "-f", "1" });
+    ae1.parse();
+    assert(f == "1");
+
+    Argengine ae2(schema, { "test", "--foo=2" });
+    ae2.parse();
+    assert(f == "2");
+}
+
+void testCompiledSchema_RequiredOptionState_ShouldNotLeakBetweenParses()
+{
+    Argengine configuration({ "test" });
+    configuration.addOption(
+      { "-f" }, [] {}, true);
+    const auto schema = configuration.compile();
+
+    Argengine ae1(schema, { "test", "-f" });
+    ae1.parse();
+
+    Argengine ae2(schema, { "test" });
+    std::string error;
+    try {
+        ae2.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Option '-f' is required!");
+}
+
+void testCompiledSchema_AddOptionAfterCompile_ShouldNotModifySchema()
+{
+    Argengine configuration({ "test" });
+    configuration.addOption({ "-f" }, [] {});
+    const auto schema = configuration.compile();
+
+    Argengine ae(schema, { "test", "-b" });
+    bool b {};
+    ae.addOption({ "-b" }, [&] {
+        b = true;
+    });
+    ae.parse();
+    assert(b);
+
+    Argengine ae2(schema, { "test", "-b" });
+    std::string error;
+    try {
+        ae2.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Unknown option '-b'!");
+}
+
+void testCompiledSchema_HelpPrintedToOwnStream_ShouldSucceed()
+{
+    std::stringstream ss;
+    {
+        Argengine configuration({ "test" });
+        const auto schema = configuration.compile();
+        Argengine ae(schema, { "test" });
+        ae.setOutputStream(ss);
+        ae.printHelp();
+    }
+    assert(ss.str() == "Usage: test [OPTIONS]\n\nOptions:\n\n-h, --help  Show this help.\n\n");
+}
+
+void testCompiledSchema_ConcurrentParses_ShouldSucceed()
+{
+    Argengine configuration({ "test" });
+    std::atomic<size_t> sum {};
+    configuration.addOption({ "-n" }, [&](std::string value) {
+        sum += std::stoul(value);
+    });
+    configuration.addOption({ "-v" }, [] {});
+    configuration.addConflictingOptions({ "-n", "-x" });
+    const auto schema = configuration.compile();
+
+    const size_t threadCount = 4;
+    const size_t parseCount = 1000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([=] {
+            for (size_t i = 0; i < parseCount; i++) {
+                Argengine ae(schema, { "test", "-v", "-n", "1" });
+                ae.parse();
+            }
+        });
+    }
+    for (auto && thread : threads) {
+        thread.join();
+    }
+    assert(sum == threadCount * parseCount);
+}
+
+int main(int, char **)
+{
+    testCompiledSchema_MultipleParses_ShouldSucceed();
+
+    testCompiledSchema_RequiredOptionState_ShouldNotLeakBetweenParses();
+
+    testCompiledSchema_AddOptionAfterCompile_ShouldNotModifySchema();
+
+    testCompiledSchema_HelpPrintedToOwnStream_ShouldSucceed();
+
+    testCompiledSchema_ConcurrentParses_ShouldSucceed();
+
+    return EXIT_SUCCESS;
+}
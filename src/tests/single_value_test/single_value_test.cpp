@@ -55,6 +55,29 @@ void testSingleValue_NoValueGiven_ShouldFail()
     assert(error == std::string(name) + ": No value for option '-f' given!");
 }
 
+void testSingleValue_OptionGivenAsValue_ShouldFail()
+{
+    Argengine ae({ "test", "-a", "1", "-f", "-b" });
+    bool called {};
+    ae.addOption({ "-a" }, [&](std::string) {
+        called = true;
+    });
+    ae.addOption({ "-f" }, [&](std::string) {
+        called = true;
+    });
+    ae.addOption({ "-b" }, [&] {
+        called = true;
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(!called);
+    assert(error == std::string(name) + ": No value for option '-f' given!");
+}
+
 void testSingleValue_ValueGiven_ShouldSucceed()
 {
     Argengine ae({ "test", "-f", "42" });
@@ -68,6 +91,44 @@ void testSingleValue_ValueGiven_ShouldSucceed()
     assert(f == ae.arguments().at(2));
 }
 
+void testSingleValue_ValueGiven_ArgumentStorageView_ShouldSucceed()
+{
+    char arg0[] = "test", arg1[] = "-f", arg2[] = "42", arg3[] = "-g=43", arg4[] = "-h44";
+    char * argv[] = { arg0, arg1, arg2, arg3, arg4 };
+    Argengine ae(5, argv, Argengine::ArgumentStorage::View, false);
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-f" }, [&](std::string value) {
+        values["f"] = value;
+    });
+    ae.addOption({ "-g" }, [&](std::string value) {
+        values["g"] = value;
+    });
+    ae.addOption({ "-h" }, [&](std::string value) {
+        values["h"] = value;
+    });
+    ae.parse();
+    assert(values["f"] == "42");
+    assert(values["g"] == "43");
+    assert(values["h"] == "44");
+    assert(ae.arguments().at(3) == "-g=43");
+}
+
+void testSingleValue_ValueGiven_StringViewCallback_ShouldSucceed()
+{
+    Argengine ae({ "test", "-f", "42", "-g=43" });
+    std::string f, g;
+    ae.addOption({ "-f" }, [&](std::string_view value) {
+        f = value;
+    });
+    const Argengine::SingleStringViewCallback gCallback = [&](std::string_view value) {
+        g = value;
+    };
+    ae.addOption({ "-g" }, gCallback);
+    ae.parse();
+    assert(f == "42");
+    assert(g == "43");
+}
+
 void testSingleValue_ValueGivenWithAssignment_ShouldSucceed()
 {
     Argengine ae({ "test", "f=42", "g==" });
@@ -172,6 +233,37 @@ void testSingleValue_MultipleValuesGivenWithoutSpaces_ShouldSucceed()
     assert(values["ccc"] == "333");
 }
 
+void testSingleValue_ValueGivenWithoutSpace_LongestVariantShouldMatch()
+{
+    Argengine ae({ "test", "--levelDEBUG" });
+    std::string level;
+    ae.addOption({ "--lev", "--level" }, [&](std::string value) {
+        level = value;
+    });
+    ae.parse();
+    assert(level == "DEBUG");
+}
+
+void testSingleValue_ValueGivenWithoutSpace_AmbiguousShouldFail()
+{
+    Argengine ae({ "test", "-abc" });
+    bool called {};
+    ae.addOption({ "-a" }, [&](std::string) {
+        called = true;
+    });
+    ae.addOption({ "-ab" }, [&](std::string) {
+        called = true;
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(!called);
+    assert(error == std::string(name) + ": Unknown option '-abc'!");
+}
+
 void testSingleValue_MultipleValueArguments_ShouldSucceed()
 {
     Argengine ae({ "test", "-a", "1", "-b", "2", "-c", "3" });
@@ -274,10 +366,16 @@ int main(int, char **)
 {
     testSingleValue_NoValueGiven_ShouldFail();
 
+    testSingleValue_OptionGivenAsValue_ShouldFail();
+
     testSingleValue_ValueGiven_ShouldSucceed();
 
     testSingleValue_MultipleValueArguments_ShouldSucceed();
 
+    testSingleValue_ValueGiven_ArgumentStorageView_ShouldSucceed();
+
+    testSingleValue_ValueGiven_StringViewCallback_ShouldSucceed();
+
     testSingleValue_NoValueGivenWithAssignment_ShouldFail();
 
     testSingleValue_ValueGivenWithAssignment_ShouldSucceed();
@@ -290,6 +388,10 @@ int main(int, char **)
 
     testSingleValue_MultipleValuesGivenWithoutSpaces_ShouldSucceed();
 
+    testSingleValue_ValueGivenWithoutSpace_LongestVariantShouldMatch();
+
+    testSingleValue_ValueGivenWithoutSpace_AmbiguousShouldFail();
+
     testSingleValue_RequiredButNotGiven_ShouldFail();
 
     testSingleValue_RequiredAndGiven_ShouldSucceed();
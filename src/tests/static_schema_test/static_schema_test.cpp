@@ -0,0 +1,287 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+constexpr std::array<Argengine::StaticOption, 4> options = { {
+  { { "-a", "--all" } },
+  { { "-f", "--foo" }, true },
+  { { "-o", "--output" }, true },
+  { { "-r" }, false, true },
+} };
+
+constexpr Argengine::Static<options.size()> schema { options, true };
+
+static_assert(schema.find("-a") == 0);
+static_assert(schema.find("--foo") == 1);
+static_assert(schema.find("--output") == 2);
+static_assert(schema.find("-r") == 3);
+static_assert(schema.find("-x") == Argengine::Static<options.size()>::Positional);
+
+constexpr size_t manyOptionCount = 500;
+
+struct ManyVariants
+{
+    static constexpr size_t ShortLength = 5;
+
+    static constexpr size_t LongLength = 12;
+
+    // "-o000", "-o001", ...
+    std::array<char, manyOptionCount * ShortLength> shortVariants {};
+
+    // "--option-000", "--option-001", ...
+    std::array<char, manyOptionCount * LongLength> longVariants {};
+};
+
+constexpr ManyVariants makeManyVariants()
+{
+    ManyVariants variants;
+    for (size_t i = 0; i < manyOptionCount; i++) {
+        const char digits[] = { static_cast<char>('0' + i / 100), static_cast<char>('0' + i / 10 % 10), static_cast<char>('0' + i % 10) };
+        const char shortPrefix[] = "-o";
+        const char longPrefix[] = "--option-";
+        for (size_t j = 0; j < ManyVariants::ShortLength; j++) {
+            variants.shortVariants[i * ManyVariants::ShortLength + j] = j < 2 ? shortPrefix[j] : digits[j - 2];
+        }
+        for (size_t j = 0; j < ManyVariants::LongLength; j++) {
+            variants.longVariants[i * ManyVariants::LongLength + j] = j < 9 ? longPrefix[j] : digits[j - 9];
+        }
+    }
+    return variants;
+}
+
+constexpr auto manyVariants = makeManyVariants();
+
+constexpr std::array<Argengine::StaticOption, manyOptionCount> makeManyOptions()
+{
+    std::array<Argengine::StaticOption, manyOptionCount> options {};
+    for (size_t i = 0; i < manyOptionCount; i++) {
+        options[i].variants[0] = { manyVariants.shortVariants.data() + i * ManyVariants::ShortLength, ManyVariants::ShortLength };
+        options[i].variants[1] = { manyVariants.longVariants.data() + i * ManyVariants::LongLength, ManyVariants::LongLength };
+        options[i].hasValue = i % 2;
+    }
+    return options;
+}
+
+constexpr auto manyOptions = makeManyOptions();
+
+constexpr Argengine::Static<manyOptionCount> manySchema { manyOptions, true };
+
+static_assert(manySchema.find("-o000") == 0);
+static_assert(manySchema.find("--option-123") == 123);
+static_assert(manySchema.find("-o499") == 499);
+static_assert(manySchema.find("-o500") == Argengine::Static<manyOptionCount>::Positional);
+
+using Arguments = std::vector<std::string>;
+
+std::vector<char *> toArgv(Arguments & args)
+{
+    std::vector<char *> argv;
+    for (auto && arg : args) {
+        argv.push_back(arg.data());
+    }
+    return argv;
+}
+
+void testStaticSchema_AllFormats_ShouldSucceed()
+{
+    Arguments args { "test", "--all", "-f", "1", "--output=2", "-r", "a", "-f3" };
+    auto argv = toArgv(args);
+    std::vector<std::pair<size_t, std::string>> visited;
+    schema.parse(static_cast<int>(argv.size()), argv.data(), [&](size_t option, std::string_view value) {
+        visited.push_back({ option, std::string { value } });
+    });
+    const std::vector<std::pair<size_t, std::string>> expected = {
+        { 0, "" },
+        { 1, "1" },
+        { 2, "2" },
+        { 3, "" },
+        { Argengine::Static<options.size()>::Positional, "a" },
+        { 1, "3" }
+    };
+    assert(visited == expected);
+}
+
+void testStaticSchema_EndOfOptions_ShouldTreatOptionsAsPositional()
+{
+    Arguments args { "test", "-r", "--", "-a", "--foo=1" };
+    auto argv = toArgv(args);
+    std::vector<std::pair<size_t, std::string>> visited;
+    schema.parse(static_cast<int>(argv.size()), argv.data(), [&](size_t option, std::string_view value) {
+        visited.push_back({ option, std::string { value } });
+    });
+    const std::vector<std::pair<size_t, std::string>> expected = {
+        { 3, "" },
+        { Argengine::Static<options.size()>::Positional, "-a" },
+        { Argengine::Static<options.size()>::Positional, "--foo=1" }
+    };
+    assert(visited == expected);
+}
+
+void testStaticSchema_SpacelessPrefixes_ShouldMatchExactFirstAndRejectAmbiguous()
+{
+    constexpr std::array<Argengine::StaticOption, 3> prefixOptions = { {
+      { { "-l", "--level" }, true },
+      { { "-lv" } },
+      { { "--lev" }, true },
+    } };
+    constexpr Argengine::Static<prefixOptions.size()> prefixSchema { prefixOptions, true };
+    Arguments args { "test", "-lv", "-lx", "-lvx", "--lev3", "--levelDEBUG" };
+    auto argv = toArgv(args);
+    std::vector<std::pair<size_t, std::string>> visited;
+    prefixSchema.parse(static_cast<int>(argv.size()), argv.data(), [&](size_t option, std::string_view value) {
+        visited.push_back({ option, std::string { value } });
+    });
+    const std::vector<std::pair<size_t, std::string>> expected = {
+        { 1, "" },
+        { 0, "x" },
+        { Argengine::Static<prefixOptions.size()>::Positional, "-lvx" },
+        { 2, "3" },
+        { Argengine::Static<prefixOptions.size()>::Positional, "--levelDEBUG" }
+    };
+    assert(visited == expected);
+}
+
+void testStaticSchema_ManyOptions_ShouldFindAllVariants()
+{
+    for (auto && option : manyOptions) {
+        for (auto && variant : option.variants) {
+            if (!variant.empty()) {
+                assert(manySchema.find(variant) == static_cast<size_t>(&option - manyOptions.data()));
+            }
+        }
+    }
+    Arguments args { "test", "-o000", "--option-001=a", "-o499b", "--option-500", "-o42" };
+    auto argv = toArgv(args);
+    std::vector<std::pair<size_t, std::string>> visited;
+    manySchema.parse(static_cast<int>(argv.size()), argv.data(), [&](size_t option, std::string_view value) {
+        visited.push_back({ option, std::string { value } });
+    });
+    const std::vector<std::pair<size_t, std::string>> expected = {
+        { 0, "" },
+        { 1, "a" },
+        { 499, "b" },
+        { Argengine::Static<manyOptionCount>::Positional, "--option-500" },
+        { Argengine::Static<manyOptionCount>::Positional, "-o42" }
+    };
+    assert(visited == expected);
+}
+
+void testStaticSchema_RequiredNotGiven_ShouldFail()
+{
+    Arguments args { "test", "-a" };
+    auto argv = toArgv(args);
+    bool called {};
+    Argengine::Error error;
+    schema.parse(
+      static_cast<int>(argv.size()), argv.data(), [&](size_t, std::string_view) {
+          called = true;
+      },
+      error);
+    assert(!called);
+    assert(error.code == Argengine::Error::Code::Required);
+    assert(error.message == std::string(name) + ": Option '-r' is required!");
+}
+
+void testStaticSchema_NoValueGiven_ShouldFail()
+{
+    Arguments args { "test", "-r", "-f", "-a" };
+    auto argv = toArgv(args);
+    bool called {};
+    Argengine::Error error;
+    schema.parse(
+      static_cast<int>(argv.size()), argv.data(), [&](size_t, std::string_view) {
+          called = true;
+      },
+      error);
+    assert(!called);
+    assert(error.message == std::string(name) + ": No value for option '-f, --foo' given!");
+}
+
+void testStaticSchema_UnknownOption_ShouldFail()
+{
+    constexpr Argengine::Static<options.size()> strictSchema { options };
+    Arguments args { "test", "-r", "--bar" };
+    auto argv = toArgv(args);
+    std::string error;
+    try {
+        strictSchema.parse(static_cast<int>(argv.size()), argv.data(), [](size_t, std::string_view) {
+        });
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Unknown option '--bar'!");
+}
+
+void testStaticSchema_DuplicateVariants_ShouldFail()
+{
+    // A constexpr schema would not compile
+    const std::array<Argengine::StaticOption, 2> duplicateOptions = { {
+      { { "-a", "--all" } },
+      { { "-b", "--all" } },
+    } };
+    std::string error;
+    try {
+        Argengine::Static<duplicateOptions.size()> duplicateSchema { duplicateOptions };
+    } catch (std::logic_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Option '--all' already defined!");
+}
+
+int main(int, char **)
+{
+    testStaticSchema_AllFormats_ShouldSucceed();
+
+    testStaticSchema_EndOfOptions_ShouldTreatOptionsAsPositional();
+
+    testStaticSchema_SpacelessPrefixes_ShouldMatchExactFirstAndRejectAmbiguous();
+
+    testStaticSchema_ManyOptions_ShouldFindAllVariants();
+
+    testStaticSchema_RequiredNotGiven_ShouldFail();
+
+    testStaticSchema_NoValueGiven_ShouldFail();
+
+    testStaticSchema_UnknownOption_ShouldFail();
+
+    testStaticSchema_DuplicateVariants_ShouldFail();
+
+    return EXIT_SUCCESS;
+}
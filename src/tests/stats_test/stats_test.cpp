@@ -0,0 +1,201 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "../../argengine.hpp"
+#include "../test_file.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <memory_resource>
+#include <stdexcept>
+
+using juzzlin::Argengine;
+
+class TestResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+
+    size_t allocatedBytes = 0;
+
+private:
+    void * do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        allocatedBytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void * ptr, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+void testStats_NotParsed_ShouldBeZero()
+{
+    const Argengine ae({ "test", "-a" });
+    const auto stats = ae.stats();
+    assert(stats.allocations == 0);
+    assert(stats.allocatedBytes == 0);
+    assert(stats.tokens == 0);
+    assert(stats.lookups == 0);
+    assert(stats.tokenizeTime.count() == 0);
+    assert(stats.dispatchTime.count() == 0);
+}
+
+void testStats_Parsed_ShouldCountTokensAndLookups()
+{
+    Argengine ae({ "test", "-a", "1", "--bb=2", "-c3", "foo" });
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    ae.addOption({ "--bb" }, [](std::string_view) {
+    });
+    ae.addOption({ "-c" }, [](std::string_view) {
+    });
+    ae.setPositionalArgumentCallback([](Argengine::ArgumentVector) {
+    });
+    ae.parse();
+    const auto stats = ae.stats();
+    assert(stats.tokens == 7);
+    assert(stats.lookups > stats.tokens);
+    assert(stats.allocations > 0);
+    assert(stats.allocatedBytes > 0);
+    assert(stats.tokenizeTime.count() > 0);
+    assert(stats.resolveTime.count() > 0);
+    assert(stats.dispatchTime.count() > 0);
+}
+
+void testStats_ParsedTwice_ShouldNotAccumulate()
+{
+    Argengine ae({ "test", "-a", "1" });
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    ae.parse();
+    const auto first = ae.stats();
+    ae.parse();
+    const auto second = ae.stats();
+    assert(first.tokens == second.tokens);
+    assert(first.lookups == second.lookups);
+    assert(first.bufferBytes == second.bufferBytes);
+}
+
+void testStats_Reparsed_ShouldReuseBuffer()
+{
+    Argengine ae({ "test", "-a", "1", "-b", "2", "foo", "bar" });
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    ae.addOption({ "-b" }, [](std::string_view) {
+    });
+    ae.setPositionalArgumentCallback([](Argengine::ArgumentVector) {
+    });
+    ae.parse();
+    const auto first = ae.stats();
+    assert(first.allocations > 0);
+    assert(first.bufferBytes > 0);
+    ae.parse();
+    ae.parse();
+    const auto third = ae.stats();
+    assert(third.allocations == 0);
+    assert(third.allocatedBytes == 0);
+    assert(third.bufferBytes == first.bufferBytes);
+}
+
+void testStats_ParseFailed_ShouldBeValidUpToFailure()
+{
+    Argengine ae({ "test", "-a", "1", "-b" });
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    try {
+        ae.parse();
+    } catch (std::runtime_error &) {
+    }
+    const auto stats = ae.stats();
+    assert(stats.tokens == 3);
+    assert(stats.allocations > 0);
+    assert(stats.requiredCheckTime.count() == 0);
+}
+
+void testStats_FilesSubcommandAndResult_ShouldCountAllAllocationsOfParse()
+{
+    TestResource resource;
+    const auto responseFile = writeFile("argengine_stats_test.rsp", "-a 1 foo");
+    const auto configFile = writeFile("argengine_stats_test.conf", "b = 2\n");
+    Argengine ae({ "test", "@" + responseFile, "build", "-v" }, true, &resource);
+    ae.addOption({ "-a" }, [](std::string_view) {
+    });
+    ae.addOption({ "-b" }, [](std::string_view) {
+    });
+    ae.setPositionalArgumentCallback([](Argengine::StringViewSpan) {
+    });
+    ae.addSubcommand("build", [](Argengine & subcommand) {
+        subcommand.addOption({ "-v" }, [] {
+        });
+    });
+    ae.setResponseFileExpansion(true);
+    ae.setConfigFile(configFile);
+    ae.parse();
+
+    auto allocations = resource.allocations;
+    auto allocatedBytes = resource.allocatedBytes;
+    ae.parse();
+    assert(ae.stats().allocations > 0);
+    assert(ae.stats().allocations == resource.allocations - allocations);
+    assert(ae.stats().allocatedBytes == resource.allocatedBytes - allocatedBytes);
+
+    allocations = resource.allocations;
+    allocatedBytes = resource.allocatedBytes;
+    const auto result = ae.parseResult();
+    assert(result.value("-b") == "2");
+    assert(ae.stats().allocations == resource.allocations - allocations);
+    assert(ae.stats().allocatedBytes == resource.allocatedBytes - allocatedBytes);
+}
+
+int main(int, char **)
+{
+    testStats_NotParsed_ShouldBeZero();
+
+    testStats_Parsed_ShouldCountTokensAndLookups();
+
+    testStats_ParsedTwice_ShouldNotAccumulate();
+
+    testStats_Reparsed_ShouldReuseBuffer();
+
+    testStats_ParseFailed_ShouldBeValidUpToFailure();
+
+    testStats_FilesSubcommandAndResult_ShouldCountAllAllocationsOfParse();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testSubcommand_SubcommandGiven_ShouldRunOnlyItsFactory()
+{
+    Argengine ae({ "test", "-v", "build", "-v", "--release", "x" });
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-v" }, [&] {
+        values["v"] = "called";
+    });
+    ae.addSubcommand("build", [&](Argengine & build) {
+        values["build"] = "called";
+        build.addOption({ "-v" }, [&] {
+            values["build -v"] = "called";
+        });
+        build.addOption({ "--release" }, [&] {
+            values["build --release"] = "called";
+        });
+        build.setPositionalArgumentCallback([&](Argengine::ArgumentVector args) {
+            values["build args"] = args.at(0);
+        });
+    });
+    ae.addSubcommand("deploy", [&](Argengine &) {
+        values["deploy"] = "called";
+    });
+    ae.parse();
+    assert(values["v"] == "called");
+    assert(values["build"] == "called");
+    assert(values["build -v"] == "called");
+    assert(values["build --release"] == "called");
+    assert(values["build args"] == "x");
+    assert(!values.count("deploy"));
+}
+
+void testSubcommand_SubcommandAsValue_ShouldNotRunSubcommand()
+{
+    Argengine ae({ "test", "-o", "build", "deploy", "-o", "build" });
+    std::map<std::string, std::string> values;
+    ae.addOption({ "-o" }, [&](std::string value) {
+        values["o"] = value;
+    });
+    ae.addSubcommand("build", [&](Argengine &) {
+        values["build"] = "called";
+    });
+    ae.addSubcommand("deploy", [&](Argengine & deploy) {
+        deploy.addOption({ "-o" }, [&](std::string value) {
+            values["deploy -o"] = value;
+        });
+    });
+    ae.parse();
+    assert(values["o"] == "build");
+    assert(values["deploy -o"] == "build");
+    assert(!values.count("build"));
+}
+
+void testSubcommand_NoSubcommandGiven_ShouldNotRunFactories()
+{
+    Argengine ae({ "test", "-v" });
+    bool called {};
+    ae.addOption({ "-v" }, [] {
+    });
+    ae.addSubcommand("build", [&](Argengine &) {
+        called = true;
+    });
+    ae.parse();
+    assert(!called);
+}
+
+void testSubcommand_UnknownOptionOfSubcommand_ShouldFail()
+{
+    Argengine ae({ "test", "build", "-v" });
+    bool called {};
+    ae.addOption({ "-v" }, [&] {
+        called = true;
+    });
+    ae.addSubcommand("build", [](Argengine &) {
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(!called);
+    assert(error == std::string(name) + ": Unknown option '-v'!");
+}
+
+void testSubcommand_UnknownOptionOfSubcommand_ShouldNotCallOptionsOfParent()
+{
+    Argengine ae({ "test", "-v", "build", "--bogus" });
+    bool called {};
+    ae.addOption({ "-v" }, [&] {
+        called = true;
+    });
+    ae.addSubcommand("build", [](Argengine &) {
+    });
+    Argengine::Error error;
+    ae.parse(error);
+    assert(!called);
+    assert(error.code == Argengine::Error::Code::UnknownOption);
+}
+
+void testSubcommand_OptionsGiven_ShouldCallParentFirst()
+{
+    Argengine ae({ "test", "-v", "build", "--release" });
+    std::string order;
+    ae.addOption({ "-v" }, [&] {
+        order += "v";
+    });
+    ae.addSubcommand("build", [&](Argengine & build) {
+        build.addOption({ "--release" }, [&] {
+            order += "r";
+        });
+    });
+    ae.parse();
+    assert(order == "vr");
+}
+
+void testSubcommand_RequiredOptionOfSubcommand_ShouldFail()
+{
+    Argengine ae({ "test", "build" });
+    ae.addSubcommand("build", [](Argengine & build) {
+        build.addOption(
+          { "-t", "--target" }, [](std::string) {
+          },
+          true);
+    });
+    Argengine::Error error;
+    ae.parse(error);
+    assert(error.code == Argengine::Error::Code::Required);
+    assert(error.message == std::string(name) + ": Option '-t, --target' is required!");
+}
+
+void testSubcommand_SameSubcommandTwice_ShouldFail()
+{
+    Argengine ae({ "test" });
+    ae.addSubcommand("build", [](Argengine &) {
+    });
+    std::string error;
+    try {
+        ae.addSubcommand("build", [](Argengine &) {
+        });
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Subcommand 'build' already defined!");
+}
+
+void testSubcommand_Help_ShouldListSubcommands()
+{
+    Argengine ae({ "test" });
+    std::stringstream ss;
+    ae.setOutputStream(ss);
+    ae.addSubcommand(
+      "build", [](Argengine &) {
+      },
+      "Build the project.");
+    ae.addSubcommand(
+      "deploy", [](Argengine &) {
+      },
+      "Deploy the project.");
+    ae.printHelp();
+    const std::string answer = std::string { "Usage: test [OPTIONS]\n\nOptions:\n\n" } + //
+      "-h, --help  Show this help.\n\n" + //
+      "Commands:\n\n" + //
+      "build       Build the project.\n" + //
+      "deploy      Deploy the project.\n\n";
+    assert(ss.str() == answer);
+}
+
+void testSubcommand_HelpOfSubcommand_ShouldShowSubcommandName()
+{
+    Argengine ae({ "test", "build" });
+    std::stringstream ss;
+    ae.setOutputStream(ss);
+    ae.addSubcommand("build", [](Argengine & build) {
+        build.printHelp();
+    });
+    ae.parse();
+    assert(ss.str() == "Usage: test build [OPTIONS]\n\nOptions:\n\n-h, --help  Show this help.\n\n");
+}
+
+void testSubcommand_SharedSchema_ShouldRunSubcommand()
+{
+    size_t calls {};
+    Argengine ae({ "test" });
+    ae.addSubcommand("build", [&](Argengine & build) {
+        build.addOption({ "-j" }, [&](std::string) {
+            calls++;
+        });
+    });
+    const auto schema = ae.compile();
+    for (size_t i = 0; i < 3; i++) {
+        Argengine parser(schema, { "test", "build", "-j", "8" });
+        parser.parse();
+    }
+    assert(calls == 3);
+}
+
+int main(int, char **)
+{
+    testSubcommand_SubcommandGiven_ShouldRunOnlyItsFactory();
+
+    testSubcommand_SubcommandAsValue_ShouldNotRunSubcommand();
+
+    testSubcommand_NoSubcommandGiven_ShouldNotRunFactories();
+
+    testSubcommand_UnknownOptionOfSubcommand_ShouldFail();
+
+    testSubcommand_UnknownOptionOfSubcommand_ShouldNotCallOptionsOfParent();
+
+    testSubcommand_OptionsGiven_ShouldCallParentFirst();
+
+    testSubcommand_RequiredOptionOfSubcommand_ShouldFail();
+
+    testSubcommand_SameSubcommandTwice_ShouldFail();
+
+    testSubcommand_Help_ShouldListSubcommands();
+
+    testSubcommand_HelpOfSubcommand_ShouldShowSubcommandName();
+
+    testSubcommand_SharedSchema_ShouldRunSubcommand();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef JUZZLIN_ARGENGINE_TEST_FILE_HPP
+#define JUZZLIN_ARGENGINE_TEST_FILE_HPP
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+//! Writes a fixture file to the temp directory.
+//! \return Path to the file.
+inline std::string writeFile(const std::string & fileName, const std::string & content)
+{
+    const auto path = (std::filesystem::temp_directory_path() / fileName).string();
+    std::ofstream out { path, std::ios::binary };
+    out << content;
+    return path;
+}
+
+#endif // JUZZLIN_ARGENGINE_TEST_FILE_HPP
@@ -0,0 +1,210 @@
+// MIT License
+//
+// Copyright (c) 2026 Jussi Lind <jussi.lind@iki.fi>
+//
+// https://github.com/juzzlin/Argengine
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "../../argengine.hpp"
+
+// Don't compile asserts away
+#ifdef NDEBUG
+    #undef NDEBUG
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+using juzzlin::Argengine;
+
+const auto name = "Argengine";
+
+void testTypedValue_ValuesGiven_ShouldSucceed()
+{
+    Argengine ae({ "test", "-n", "-42", "--ratio=0.25", "-vtrue", "--debug", "off" });
+    int64_t n {};
+    ae.addOption<int64_t>({ "-n" }, [&](int64_t value) {
+        n = value;
+    });
+    double ratio {};
+    ae.addOption<double>({ "--ratio" }, [&](double value) {
+        ratio = value;
+    });
+    bool verbose {};
+    ae.addOption<bool>({ "-v" }, [&](bool value) {
+        verbose = value;
+    });
+    bool debug = true;
+    ae.addOption<bool>({ "--debug" }, [&](bool value) {
+        debug = value;
+    });
+    ae.parse();
+    assert(n == -42);
+    assert(ratio == 0.25);
+    assert(verbose);
+    assert(!debug);
+}
+
+void testTypedValue_InvalidValueGiven_ShouldFail()
+{
+    Argengine ae({ "test", "-a", "1", "-n", "12abc" });
+    bool called {};
+    ae.addOption({ "-a" }, [&](std::string) {
+        called = true;
+    });
+    ae.addOption<int64_t>({ "-n" }, [&](int64_t) {
+        called = true;
+    });
+    Argengine::Error error;
+    ae.parse(error);
+    assert(!called);
+    assert(error.code == Argengine::Error::Code::InvalidValue);
+    assert(error.message == std::string(name) + ": Invalid value '12abc' for option '-n'!");
+}
+
+void testTypedValue_InvalidBoolGiven_ShouldFail()
+{
+    Argengine ae({ "test", "-v", "maybe" });
+    ae.addOption<bool>({ "-v" }, [](bool) {
+    });
+    Argengine::Error error;
+    ae.parse(error);
+    assert(error.code == Argengine::Error::Code::InvalidValue);
+}
+
+void testTypedValue_ValueOutOfRange_ShouldFail()
+{
+    Argengine ae({ "test", "-j", "65" });
+    bool called {};
+    ae.addOption<int64_t>(
+      { "-j" }, [&](int64_t) {
+          called = true;
+      },
+      { 1, 64 });
+    Argengine::Error error;
+    ae.parse(error);
+    assert(!called);
+    assert(error.code == Argengine::Error::Code::OutOfRange);
+    assert(error.message == std::string(name) + ": Value '65' for option '-j' is out of range [1, 64]!");
+}
+
+void testTypedValue_ValueOverflows_ShouldFail()
+{
+    Argengine ae({ "test", "-n", "99999999999999999999" });
+    ae.addOption<int64_t>({ "-n" }, [](int64_t) {
+    });
+    Argengine::Error error;
+    ae.parse(error);
+    assert(error.code == Argengine::Error::Code::OutOfRange);
+}
+
+void testTypedValue_ValueInRange_ShouldSucceed()
+{
+    Argengine ae({ "test", "-s", "0.5" });
+    double scale {};
+    ae.addOption<double>(
+      { "-s" }, [&](double value) {
+          scale = value;
+      },
+      { 0.0, 1.0 }, true);
+    ae.parse();
+    assert(scale == 0.5);
+}
+
+void testTypedValue_NanGiven_ShouldFail()
+{
+    for (auto && value : { "nan", "-nan", "NAN" }) {
+        Argengine ae({ "test", "-s", value });
+        bool called {};
+        ae.addOption<double>(
+          { "-s" }, [&](double) {
+              called = true;
+          },
+          { 0.0, 1.0 });
+        Argengine::Error error;
+        ae.parse(error);
+        assert(!called);
+        assert(error.code == Argengine::Error::Code::InvalidValue);
+    }
+}
+
+void testTypedValue_InfinityGiven_ShouldFailUnlessInRange()
+{
+    for (auto && value : { "inf", "-inf", "infinity" }) {
+        Argengine ae({ "test", "-s", value });
+        ae.addOption<double>({ "-s" }, [](double) {
+        });
+        Argengine::Error error;
+        ae.parse(error);
+        assert(error.code == Argengine::Error::Code::OutOfRange);
+    }
+
+    Argengine ae({ "test", "-s", "inf" });
+    double scale {};
+    const auto infinity = std::numeric_limits<double>::infinity();
+    ae.addOption<double>(
+      { "-s" }, [&](double value) {
+          scale = value;
+      },
+      { -infinity, infinity });
+    ae.parse();
+    assert(scale == infinity);
+}
+
+void testTypedValue_InvalidValueGiven_ShouldThrow()
+{
+    Argengine ae({ "test", "-s", "" });
+    ae.addOption<double>({ "-s" }, [](double) {
+    });
+    std::string error;
+    try {
+        ae.parse();
+    } catch (std::runtime_error & e) {
+        error = e.what();
+    }
+    assert(error == std::string(name) + ": Invalid value '' for option '-s'!");
+}
+
+int main(int, char **)
+{
+    testTypedValue_ValuesGiven_ShouldSucceed();
+
+    testTypedValue_InvalidValueGiven_ShouldFail();
+
+    testTypedValue_InvalidBoolGiven_ShouldFail();
+
+    testTypedValue_ValueOutOfRange_ShouldFail();
+
+    testTypedValue_ValueOverflows_ShouldFail();
+
+    testTypedValue_ValueInRange_ShouldSucceed();
+
+    testTypedValue_NanGiven_ShouldFail();
+
+    testTypedValue_InfinityGiven_ShouldFailUnlessInRange();
+
+    testTypedValue_InvalidValueGiven_ShouldThrow();
+
+    return EXIT_SUCCESS;
+}